@@ -0,0 +1,574 @@
+#include "items/barcodeitem.h"
+#include "items/barcodepatterncache.h"
+#include "items/imageeffects.h"
+#include "items/qrcodeitem.h"
+#include "items/qrcodematrixcache.h"
+#include "models/barcodevalidator.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <QDebug>
+
+#include <functional>
+#include <limits>
+
+// 毫米与英寸的换算
+static const qreal MM_PER_INCH = 25.4;
+
+// 每个用例至少运行的次数
+static const int MIN_ITERATIONS = 5;
+
+// 测试的打印分辨率
+static const QList<int> benchDpis = {203, 300, 600};
+
+// 条形码尺寸（毫米）
+static const QSizeF barcodeSizeMm(50.0, 15.0);
+
+// 二维码尺寸（毫米）
+static const qreal qrSizeMm = 25.0;
+
+// 二维码数据长度
+static const QList<int> qrDataLengths = {16, 64, 256, 1024};
+
+/**
+ * @brief 基准测试运行器
+ *
+ * 每个用例先预热一次，再循环运行到最短时间，记录平均和最短耗时
+ */
+class BenchRunner
+{
+public:
+    BenchRunner(int minTimeMs, const QString &filter)
+        : m_minTimeMs(minTimeMs)
+        , m_filter(filter)
+        , m_sink(0)
+    {
+    }
+
+    /**
+     * @brief 运行一个用例
+     * @param group 用例组
+     * @param name 用例名称
+     * @param params 用例参数，写入结果
+     * @param fn 被测函数，返回值累加到结果中防止被优化掉
+     */
+    void run(const QString &group, const QString &name, const QJsonObject &params,
+             const std::function<qint64()> &fn)
+    {
+        const QString fullName = group + QLatin1Char('/') + name;
+        if (!selected(fullName)) {
+            return;
+        }
+
+        // 预热（填充缓存、加载字体等）
+        m_sink += fn();
+
+        qint64 iterations = 0;
+        qint64 best = std::numeric_limits<qint64>::max();
+        QElapsedTimer total;
+        total.start();
+
+        while (iterations < MIN_ITERATIONS || total.elapsed() < m_minTimeMs) {
+            QElapsedTimer timer;
+            timer.start();
+            m_sink += fn();
+            best = qMin(best, timer.nsecsElapsed());
+            ++iterations;
+        }
+
+        const double meanNs = static_cast<double>(total.nsecsElapsed()) / iterations;
+
+        QJsonObject result = params;
+        result["group"] = group;
+        result["name"] = name;
+        result["iterations"] = iterations;
+        result["mean_ns"] = meanNs;
+        result["min_ns"] = static_cast<double>(best);
+        result["ops_per_sec"] = meanNs > 0 ? 1e9 / meanNs : 0.0;
+        m_results.append(result);
+
+        QTextStream(stderr) << fullName << ": " << QString::number(meanNs / 1000.0, 'f', 2)
+                            << " us/op (" << iterations << " iterations)\n";
+    }
+
+    /**
+     * @brief 用例是否被过滤条件选中
+     * @param fullName 用例组/用例名称
+     * @return 未设置过滤条件或名称包含过滤文本时返回true
+     */
+    bool selected(const QString &fullName) const
+    {
+        return m_filter.isEmpty() || fullName.contains(m_filter, Qt::CaseInsensitive);
+    }
+
+    /**
+     * @brief 获取全部结果
+     * @return 结果数组
+     */
+    QJsonArray results() const { return m_results; }
+
+    /**
+     * @brief 获取累加值（只用于防止被测代码被优化掉）
+     * @return 累加值
+     */
+    qint64 sink() const { return m_sink; }
+
+private:
+    int m_minTimeMs;            ///< 每个用例的最短运行时间
+    QString m_filter;           ///< 用例名称过滤
+    QJsonArray m_results;       ///< 结果
+    qint64 m_sink;              ///< 被测函数返回值的累加
+};
+
+// 各条形码类型的示例数据
+static QString sampleData(BarcodeType type)
+{
+    switch (type) {
+        case BarcodeType::EAN8:
+            return "9638507";
+        case BarcodeType::EAN13:
+            return "400638133393";
+        case BarcodeType::UPC_A:
+            return "03600029145";
+        case BarcodeType::UPC_E:
+            return "0123456";
+        case BarcodeType::MSI:
+        case BarcodeType::Interleaved2of5:
+            return "12345678";
+        case BarcodeType::ITF14:
+            // ZXing的ITF写入器只接受偶数位，需要带校验位的完整14位
+            return "12345678901231";
+        case BarcodeType::Codabar:
+            return "A123456B";
+        case BarcodeType::Code39:
+        case BarcodeType::Code93:
+            return "LABEL123";
+        default:
+            return "LBL-2024-000123";
+    }
+}
+
+// 毫米换算为指定分辨率下的像素
+static int toPixels(qreal mm, int dpi)
+{
+    return qRound(mm * dpi / MM_PER_INCH);
+}
+
+// 图像字节数，作为被测函数的返回值
+static qint64 imageBytes(const QImage &image)
+{
+    return image.sizeInBytes();
+}
+
+static void benchBarcodeEncode(BenchRunner *runner)
+{
+    for (BarcodeType type : BarcodeItem::getAllTypes()) {
+        const QString typeName = BarcodeItem::getTypeName(type);
+        const QString data = sampleData(type);
+
+        QJsonObject params;
+        params["type"] = typeName;
+        params["data_length"] = data.length();
+
+        // ZXing优先（失败时回退），不经过缓存
+        params["encoder"] = "zxing";
+        runner->run("barcode.encode", typeName + "/zxing", params, [=]() {
+            return static_cast<qint64>(BarcodeItem::encodePattern(data, type, false).size());
+        });
+
+        // 只用内置编码器
+        params["encoder"] = "fallback";
+        runner->run("barcode.encode", typeName + "/fallback", params, [=]() {
+            return static_cast<qint64>(BarcodeItem::encodeFallback(data, type, false).size());
+        });
+
+        // 经过缓存（命中）
+        params["encoder"] = "cached";
+        runner->run("barcode.encode", typeName + "/cached", params, [=]() {
+            return static_cast<qint64>(BarcodeSymbol::encode(data, type).moduleCount());
+        });
+    }
+}
+
+static void benchBarcodeGenerate(BenchRunner *runner)
+{
+    for (BarcodeType type : BarcodeItem::getAllTypes()) {
+        const QString typeName = BarcodeItem::getTypeName(type);
+        const QString data = sampleData(type);
+
+        for (int dpi : benchDpis) {
+            const int width = toPixels(barcodeSizeMm.width(), dpi);
+            const int height = toPixels(barcodeSizeMm.height(), dpi);
+
+            QJsonObject params;
+            params["type"] = typeName;
+            params["dpi"] = dpi;
+            params["width"] = width;
+            params["height"] = height;
+
+            runner->run("barcode.generate", QString("%1/%2dpi").arg(typeName).arg(dpi), params, [=]() {
+                return imageBytes(BarcodeItem::generateBarcode(data, type, width, height));
+            });
+        }
+    }
+}
+
+// 批量验证的行数
+static const int validateRows = 1000000;
+
+// 生成批量验证用的记录缓冲区，每行一个带校验位的序列号
+static QByteArray validateRecords(BarcodeType type)
+{
+    const int digits = BarcodeDataValidator::dataDigits(type);
+    QByteArray records;
+
+    for (int row = 0; row < validateRows; ++row) {
+        QByteArray value = QByteArray::number(row);
+        if (digits > 0) {
+            value = value.rightJustified(digits, '0');
+            value.append(BarcodeDataValidator::checksumDigit(value.constData(), digits));
+        } else if (type == BarcodeType::Interleaved2of5) {
+            value = value.rightJustified(10, '0');
+        } else {
+            value.prepend("SN-");
+        }
+        records += value;
+        records += '\n';
+    }
+    return records;
+}
+
+static void benchBarcodeValidate(BenchRunner *runner)
+{
+    const QList<BarcodeType> types = {BarcodeType::EAN13, BarcodeType::ITF14, BarcodeType::Interleaved2of5,
+                                      BarcodeType::Code39, BarcodeType::Code128};
+
+    for (BarcodeType type : types) {
+        const QString typeName = BarcodeItem::getTypeName(type);
+        const QByteArray records = validateRecords(type);
+
+        QJsonObject params;
+        params["type"] = typeName;
+        params["rows"] = validateRows;
+        params["bytes"] = records.size();
+
+        runner->run("barcode.validate", typeName, params, [=]() {
+            return static_cast<qint64>(BarcodeDataValidator(type).validate(records).size());
+        });
+
+        // 同时输出补全后的记录
+        runner->run("barcode.validate", typeName + "/output", params, [=]() {
+            QByteArray output;
+            BarcodeDataValidator(type).validate(records, &output);
+            return static_cast<qint64>(output.size());
+        });
+    }
+}
+
+// 二维码纠错级别
+static const QList<QRErrorCorrectionLevel> qrLevels = {
+    QRErrorCorrectionLevel::Low,
+    QRErrorCorrectionLevel::Medium,
+    QRErrorCorrectionLevel::Quartile,
+    QRErrorCorrectionLevel::High
+};
+
+// 重复的字母数字内容，与常见的追溯码相近
+static QString qrSampleData(int length)
+{
+    QString data;
+    while (data.length() < length) {
+        data += "HTTPS://EXAMPLE.COM/P/0123456789/";
+    }
+    data.truncate(length);
+    return data;
+}
+
+static void benchQRCodeEncode(BenchRunner *runner)
+{
+    const QList<QPair<QREncoderBackend, QString>> backends = {
+        {QREncoderBackend::LibQREncode, "libqrencode"},
+        {QREncoderBackend::Builtin, "builtin"}
+    };
+
+    for (QRErrorCorrectionLevel level : qrLevels) {
+        const QString levelName = QRCodeItem::getErrorCorrectionLevelName(level);
+
+        for (int length : qrDataLengths) {
+            const QString data = qrSampleData(length);
+            if (QRCodeItem::moduleCount(data, level) <= 0) {
+                continue;
+            }
+
+            // 不经过缓存，比较两个编码器
+            for (const auto &backend : backends) {
+                QJsonObject params;
+                params["ecc"] = levelName;
+                params["data_length"] = length;
+                params["encoder"] = backend.second;
+
+                const QREncoderBackend encoder = backend.first;
+                runner->run("qrcode.encode", QString("%1/%2B/%3").arg(levelName).arg(length).arg(backend.second),
+                            params, [=]() {
+                    return static_cast<qint64>(QRCodeItem::encodeMatrix(data, level, encoder).width());
+                });
+            }
+        }
+    }
+}
+
+// 只含汉字模式字符（Shift JIS）的内容
+static QString qrKanjiData(int length)
+{
+    static const QString kanji = QString("\u65e5\u672c\u8a9e\u6f22\u5b57\u54c1\u756a\u88fd\u9020");
+    QString data;
+    while (data.length() < length) {
+        data += kanji;
+    }
+    data.truncate(length);
+    return data;
+}
+
+/**
+ * @brief 查找版本容量的边界
+ *
+ * 以QRencode为参照二分查找：返回仍能放入指定版本的最长内容长度
+ *
+ * @param generator 按长度生成单一模式的内容
+ * @param level 错误校正级别
+ * @param version 版本
+ * @return 最长内容长度，版本1也放不下时返回0
+ */
+static int qrVersionCapacity(const std::function<QString(int)> &generator, QRErrorCorrectionLevel level, int version)
+{
+    const int width = 17 + 4 * version;
+    auto fits = [&](int length) {
+        const QRCodeMatrix matrix = QRCodeItem::encodeMatrix(generator(length), level, QREncoderBackend::LibQREncode);
+        return matrix.isValid() && matrix.width() <= width;
+    };
+
+    // 最大容量为7089个数字
+    int low = 0;
+    int high = 7090;
+    while (high - low > 1) {
+        const int middle = (low + high) / 2;
+        if (fits(middle)) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+/**
+ * @brief 比较内置编码器与QRencode的输出
+ *
+ * 覆盖各纠错级别、数字序列号、字母数字、字节、汉字和混合内容，
+ * 以及各模式在版本9/10和26/27边界两侧的长度
+ *
+ * @param total 输出比较的符号数
+ * @return 不一致的符号数
+ */
+static int checkQRConformance(int *total)
+{
+    QStringList corpus;
+    for (int length : {1, 7, 20, 41, 100, 300, 1000, 2000}) {
+        corpus << qrSampleData(length);
+        corpus << QString("%1").arg(length * 7919LL, length > 18 ? 18 : length, 10, QChar('0')).repeated(qMax(1, length / 18));
+        corpus << QString("lbl-%1-\u00e4\u00f6\u00fc-\u6279\u53f7-").arg(length).repeated(qMax(1, length / 16));
+    }
+    for (int length : {1, 2, 7, 20, 100, 300}) {
+        corpus << qrKanjiData(length);
+    }
+    for (int serial = 0; serial < 200; ++serial) {
+        corpus << QString("SN%1").arg(serial * 104729LL, 12, 10, QChar('0'));
+    }
+
+    // 版本边界两侧：恰好填满版本9（26）和多一个字符进入版本10（27）
+    const QList<std::function<QString(int)>> generators = {
+        [](int length) { return QString(length, QChar('7')); },
+        [](int length) { return QString(length, QChar('A')); },
+        [](int length) { return QString(length, QChar('a')); },
+        qrKanjiData
+    };
+    for (const auto &generator : generators) {
+        for (QRErrorCorrectionLevel level : qrLevels) {
+            for (int version : {9, 26}) {
+                const int capacity = qrVersionCapacity(generator, level, version);
+                if (capacity > 0) {
+                    corpus << generator(capacity) << generator(capacity + 1);
+                }
+            }
+        }
+    }
+
+    int mismatches = 0;
+    *total = 0;
+    for (const QString &data : corpus) {
+        for (QRErrorCorrectionLevel level : qrLevels) {
+            const QRCodeMatrix expected = QRCodeItem::encodeMatrix(data, level, QREncoderBackend::LibQREncode);
+            const QRCodeMatrix actual = QRCodeItem::encodeMatrix(data, level, QREncoderBackend::Builtin);
+            ++*total;
+            if (expected.width() != actual.width() || expected.modules() != actual.modules()) {
+                ++mismatches;
+                qWarning() << "内置二维码编码器输出不一致:" << QRCodeItem::getErrorCorrectionLevelName(level)
+                           << data.left(32);
+            }
+        }
+    }
+    return mismatches;
+}
+
+static void benchQRCodeGenerate(BenchRunner *runner)
+{
+    for (QRErrorCorrectionLevel level : qrLevels) {
+        const QString levelName = QRCodeItem::getErrorCorrectionLevelName(level);
+
+        for (int length : qrDataLengths) {
+            const QString data = qrSampleData(length);
+
+            // 高纠错级别无法容纳的长度跳过
+            if (QRCodeItem::moduleCount(data, level) <= 0) {
+                continue;
+            }
+
+            for (int dpi : benchDpis) {
+                const int size = toPixels(qrSizeMm, dpi);
+
+                QJsonObject params;
+                params["ecc"] = levelName;
+                params["data_length"] = length;
+                params["dpi"] = dpi;
+                params["size"] = size;
+
+                runner->run("qrcode.generate",
+                            QString("%1/%2B/%3dpi").arg(levelName).arg(length).arg(dpi), params, [=]() {
+                    return imageBytes(QRCodeItem::generateQRCode(data, level, size, 0));
+                });
+
+                // 打印用1位图像，整数模块尺寸，4模块静区
+                runner->run("qrcode.mono",
+                            QString("%1/%2B/%3dpi").arg(levelName).arg(length).arg(dpi), params, [=]() {
+                    const QRCodeMatrix matrix = QRCodeMatrix::encode(data, level);
+                    return imageBytes(matrix.toImage(matrix.moduleSize(size, 4), 4));
+                });
+            }
+        }
+    }
+}
+
+// 图像效果的测试尺寸（宽、高），最大为2400万像素
+static const QList<QSize> effectSizes = {QSize(1000, 750), QSize(4000, 3000), QSize(6000, 4000)};
+
+static void benchImageEffects(BenchRunner *runner)
+{
+    for (const QSize &size : effectSizes) {
+        // 渐变填充，避免所有像素相同
+        QImage source(size, QImage::Format_RGB32);
+        for (int y = 0; y < source.height(); ++y) {
+            QRgb *line = reinterpret_cast<QRgb*>(source.scanLine(y));
+            for (int x = 0; x < source.width(); ++x) {
+                line[x] = qRgb(x & 0xFF, y & 0xFF, (x + y) & 0xFF);
+            }
+        }
+
+        const QString sizeName = QString("%1x%2").arg(size.width()).arg(size.height());
+
+        QJsonObject params;
+        params["width"] = size.width();
+        params["height"] = size.height();
+
+        // 拖动亮度滑块的情形
+        runner->run("image.effects", QString("brightness/%1").arg(sizeName), params, [=]() {
+            return imageBytes(ImageEffects(false, 30, 0).apply(source));
+        });
+
+        runner->run("image.effects", QString("gray_contrast/%1").arg(sizeName), params, [=]() {
+            return imageBytes(ImageEffects(true, 0, 40).apply(source));
+        });
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    // 没有显示环境时使用offscreen平台插件
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QApplication app(argc, argv);
+    app.setApplicationName("printer_bench");
+    app.setApplicationVersion("1.0.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Symbol generation micro-benchmarks.");
+    parser.addHelpOption();
+
+    QCommandLineOption outOption("out", "Write JSON results to file (default: stdout).", "file");
+    QCommandLineOption timeOption("min-time", "Minimum run time per case in milliseconds (default: 200).", "ms", "200");
+    QCommandLineOption filterOption("filter", "Only run cases whose group/name contains this text.", "text");
+    parser.addOption(outOption);
+    parser.addOption(timeOption);
+    parser.addOption(filterOption);
+    parser.process(app);
+
+    BenchRunner runner(qMax(1, parser.value(timeOption).toInt()), parser.value(filterOption));
+
+    benchBarcodeEncode(&runner);
+    benchBarcodeGenerate(&runner);
+    benchBarcodeValidate(&runner);
+    benchQRCodeEncode(&runner);
+    benchQRCodeGenerate(&runner);
+    benchImageEffects(&runner);
+
+    // 一致性检查也遵守过滤条件，可以用--filter qrcode.conformance单独运行
+    int conformanceTotal = 0;
+    int conformanceMismatches = 0;
+    if (runner.selected("qrcode.conformance")) {
+        conformanceMismatches = checkQRConformance(&conformanceTotal);
+        QTextStream(stderr) << "qrcode.conformance: " << conformanceMismatches << " mismatches in "
+                            << conformanceTotal << " symbols\n";
+    }
+
+    BarcodePatternCache *cache = BarcodePatternCache::instance();
+    QRCodeMatrixCache *qrCache = QRCodeMatrixCache::instance();
+
+    QJsonObject root;
+    root["benchmark"] = "printer_bench";
+    root["version"] = app.applicationVersion();
+    root["qt_version"] = QString(qVersion());
+    root["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    root["min_time_ms"] = parser.value(timeOption).toInt();
+    root["pattern_cache_hits"] = cache->hits();
+    root["pattern_cache_misses"] = cache->misses();
+    root["qr_matrix_cache_hits"] = qrCache->hits();
+    root["qr_matrix_cache_misses"] = qrCache->misses();
+    root["qr_conformance_symbols"] = conformanceTotal;
+    root["qr_conformance_mismatches"] = conformanceMismatches;
+    root["results"] = runner.results();
+    root["checksum"] = runner.sink();
+
+    const QByteArray json = QJsonDocument(root).toJson(QJsonDocument::Indented);
+
+    if (parser.isSet(outOption)) {
+        QFile file(parser.value(outOption));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qCritical() << "无法写入结果文件:" << file.fileName();
+            return 1;
+        }
+        file.write(json);
+    } else {
+        QTextStream(stdout) << json;
+    }
+
+    // 编码器输出不一致时返回非零，CTest和CI据此判定失败
+    return conformanceMismatches > 0 ? 2 : 0;
+}
@@ -0,0 +1,472 @@
+#include "headlessrenderer.h"
+#include "models/labelmodels.h"
+#include "models/datamerge.h"
+#include "items/qrcodeitem.h"
+#include "render/batchrenderer.h"
+#include "render/monorenderer.h"
+#include "print/zplexporter.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QPainter>
+#include <QPageSize>
+#include <QPageLayout>
+#include <QPrinter>
+#include <QDebug>
+
+#include <cstring>
+
+// 毫米与英寸的换算
+static const qreal MM_PER_INCH = 25.4;
+
+// 批量渲染时每次读入的记录数
+static const int RECORDS_PER_CHUNK = 1024;
+
+HeadlessRenderer::HeadlessRenderer()
+    : m_document(nullptr)
+    , m_dpi(0)
+    , m_threadCount(0)
+    , m_depth(32)
+    , m_skipInvalid(false)
+{
+}
+
+HeadlessRenderer::~HeadlessRenderer()
+{
+    delete m_document;
+}
+
+bool HeadlessRenderer::isRequested(int argc, char *argv[])
+{
+    // 只做简单扫描，完整解析在run()中进行
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--render") == 0 || std::strncmp(argv[i], "--render=", 9) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int HeadlessRenderer::run(const QStringList &arguments)
+{
+    if (!parseArguments(arguments)) {
+        return 2;
+    }
+
+    if (!loadDocument()) {
+        return 1;
+    }
+
+    // 根据输出文件后缀选择渲染方式
+    bool success = false;
+    QString suffix = QFileInfo(m_outputPath).suffix();
+    if (suffix.compare("pdf", Qt::CaseInsensitive) == 0) {
+        success = renderToPdf();
+    } else if (suffix.compare("zpl", Qt::CaseInsensitive) == 0) {
+        success = renderToZpl();
+    } else {
+        success = renderToImage();
+    }
+
+    return success ? 0 : 1;
+}
+
+bool HeadlessRenderer::parseArguments(const QStringList &arguments)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Label Printer Editor (headless render)");
+    parser.addHelpOption();
+
+    QCommandLineOption renderOption("render", "Label document to render.", "file");
+    QCommandLineOption outOption("out", "Output file (.png, .bmp, .jpg, .pdf or .zpl).", "file");
+    QCommandLineOption dpiOption("dpi", "Output resolution in dots per inch.", "dpi");
+    QCommandLineOption depthOption("depth", "Raster bits per pixel: 32 (color), 8 (grayscale) or 1 (monochrome).", "bits");
+    QCommandLineOption dataOption("data", "CSV/TSV records merged into {{column}} placeholders.", "file");
+    QCommandLineOption threadsOption("threads", "Render threads for --data raster output (default: all cores).", "count");
+    QCommandLineOption skipInvalidOption("skip-invalid", "Skip --data records with invalid barcode values instead of failing.");
+    QCommandLineOption qrEncoderOption("qr-encoder", "QR code encoder: libqrencode (default) or builtin.", "name");
+    parser.addOption(renderOption);
+    parser.addOption(outOption);
+    parser.addOption(dpiOption);
+    parser.addOption(depthOption);
+    parser.addOption(dataOption);
+    parser.addOption(threadsOption);
+    parser.addOption(skipInvalidOption);
+    parser.addOption(qrEncoderOption);
+
+    if (!parser.parse(arguments)) {
+        qCritical().noquote() << parser.errorText();
+        return false;
+    }
+
+    if (parser.isSet("help")) {
+        qInfo().noquote() << parser.helpText();
+        return false;
+    }
+
+    m_inputPath = parser.value(renderOption);
+    m_outputPath = parser.value(outOption);
+    m_dataPath = parser.value(dataOption);
+    m_skipInvalid = parser.isSet(skipInvalidOption);
+
+    if (m_inputPath.isEmpty() || m_outputPath.isEmpty()) {
+        qCritical() << "需要同时指定 --render 和 --out";
+        return false;
+    }
+
+    if (parser.isSet(dpiOption)) {
+        bool ok = false;
+        m_dpi = parser.value(dpiOption).toInt(&ok);
+        if (!ok || m_dpi <= 0) {
+            qCritical() << "无效的DPI:" << parser.value(dpiOption);
+            return false;
+        }
+    }
+
+    if (parser.isSet(depthOption)) {
+        bool ok = false;
+        m_depth = parser.value(depthOption).toInt(&ok);
+        if (!ok || (m_depth != 32 && m_depth != 8 && m_depth != 1)) {
+            qCritical() << "无效的颜色深度:" << parser.value(depthOption);
+            return false;
+        }
+    }
+
+    if (parser.isSet(threadsOption)) {
+        bool ok = false;
+        m_threadCount = parser.value(threadsOption).toInt(&ok);
+        if (!ok || m_threadCount < 0) {
+            qCritical() << "无效的线程数:" << parser.value(threadsOption);
+            return false;
+        }
+    }
+
+    // 编码器在加载文档之前选定，渲染线程共用同一设置
+    if (parser.isSet(qrEncoderOption)) {
+        const QString encoder = parser.value(qrEncoderOption);
+        if (encoder.compare("builtin", Qt::CaseInsensitive) == 0) {
+            QRCodeItem::setEncoderBackend(QREncoderBackend::Builtin);
+        } else if (encoder.compare("libqrencode", Qt::CaseInsensitive) == 0) {
+            QRCodeItem::setEncoderBackend(QREncoderBackend::LibQREncode);
+        } else {
+            qCritical() << "无效的二维码编码器:" << encoder;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool HeadlessRenderer::loadDocument()
+{
+    QFile file(m_inputPath);
+    if (!file.open(QFile::ReadOnly | QFile::Text)) {
+        qCritical() << "无法读取文件" << m_inputPath << ":" << file.errorString();
+        return false;
+    }
+
+    m_document = new LabelDocument();
+    if (!m_document->loadFromXml(&file)) {
+        qCritical() << "文件格式错误或不支持:" << m_inputPath;
+        return false;
+    }
+
+    // 未指定DPI时使用文档自身的分辨率
+    if (m_dpi <= 0) {
+        m_dpi = m_document->dpi();
+    }
+
+    return true;
+}
+
+QSize HeadlessRenderer::outputPixelSize() const
+{
+    QSizeF pageSize = m_document->pageRealSize();
+    return QSize(qMax(1, qRound(pageSize.width() * m_dpi / MM_PER_INCH)),
+                 qMax(1, qRound(pageSize.height() * m_dpi / MM_PER_INCH)));
+}
+
+QString HeadlessRenderer::outputPathForRecord(int recordNumber) const
+{
+    if (recordNumber <= 0) {
+        return m_outputPath;
+    }
+
+    QString number = QString::number(recordNumber).rightJustified(6, '0');
+    if (m_outputPath.contains("{n}")) {
+        return QString(m_outputPath).replace("{n}", number);
+    }
+
+    // 在后缀前追加记录序号
+    QFileInfo info(m_outputPath);
+    QString fileName = info.completeBaseName() + "_" + number;
+    if (!info.suffix().isEmpty()) {
+        fileName += "." + info.suffix();
+    }
+    return info.dir().filePath(fileName);
+}
+
+bool HeadlessRenderer::saveImage(QImage &image, const QString &path) const
+{
+    // 写入物理分辨率，方便打印驱动按实际尺寸输出
+    int dotsPerMeter = qRound(m_dpi * 1000.0 / MM_PER_INCH);
+    image.setDotsPerMeterX(dotsPerMeter);
+    image.setDotsPerMeterY(dotsPerMeter);
+
+    if (!image.save(path)) {
+        qCritical() << "无法写入文件:" << path;
+        return false;
+    }
+
+    return true;
+}
+
+bool HeadlessRenderer::reportInvalidRecord(int recordNumber, const QString &errorString) const
+{
+    if (m_skipInvalid) {
+        qWarning().noquote() << QString("跳过第%1条记录：%2").arg(recordNumber).arg(errorString);
+        return true;
+    }
+
+    qCritical().noquote() << QString("第%1条记录无效：%2（使用 --skip-invalid 跳过无效记录）")
+                                 .arg(recordNumber).arg(errorString);
+    return false;
+}
+
+bool HeadlessRenderer::renderToImage()
+{
+    QSize size = outputPixelSize();
+
+    MonoRenderer monoRenderer(m_document);
+    monoRenderer.setResolution(m_dpi);
+
+    if (m_dataPath.isEmpty()) {
+        QImage image;
+        if (m_depth == 8) {
+            image = monoRenderer.renderGrayscale();
+        } else if (m_depth == 1) {
+            image = monoRenderer.renderMono();
+        } else {
+            image = m_document->toImage(size);
+        }
+        return saveImage(image, m_outputPath);
+    }
+
+    QFile dataFile(m_dataPath);
+    if (!dataFile.open(QFile::ReadOnly | QFile::Text)) {
+        qCritical() << "无法读取文件" << m_dataPath << ":" << dataFile.errorString();
+        return false;
+    }
+
+    DataRecordReader reader(&dataFile);
+    if (!reader.readHeader()) {
+        qCritical() << "数据文件没有表头:" << m_dataPath;
+        return false;
+    }
+
+    DataMergeEngine engine(m_document);
+    engine.setColumns(reader.columns());
+    if (!engine.missingColumns().isEmpty()) {
+        qWarning() << "数据文件缺少列:" << engine.missingColumns();
+    }
+
+    // 模板只加载一次，记录按块读入后在线程池上并行渲染
+    BatchRenderer batch(m_document);
+    batch.setResolution(m_dpi);
+    batch.setThreadCount(m_threadCount);
+    batch.setColumns(reader.columns());
+    batch.setSkipInvalidRecords(m_skipInvalid);
+
+    // 抖动区域只取决于模板布局，所有记录共用
+    const QRegion ditherRegion = monoRenderer.ditherRegion();
+    const int threshold = monoRenderer.threshold();
+
+    QList<QStringList> chunk;
+    QList<QStringList> records;
+    QVector<int> recordNumbers;
+    QStringList record;
+    int firstRecord = 1;
+    bool done = false;
+
+    while (!done) {
+        chunk.clear();
+        while (chunk.size() < RECORDS_PER_CHUNK && reader.readRecord(&record)) {
+            chunk.append(record);
+        }
+        done = chunk.size() < RECORDS_PER_CHUNK;
+
+        // 渲染前整块验证条形码数据，跳过的记录保留原序号，输出文件与数据行对应
+        records.clear();
+        recordNumbers.clear();
+        const QVector<DataMergeEngine::RecordError> errors = engine.validate(chunk);
+        int nextError = 0;
+        for (int i = 0; i < chunk.size(); ++i) {
+            if (nextError < errors.size() && errors.at(nextError).record == i) {
+                if (!reportInvalidRecord(firstRecord + i, errors.at(nextError).errorString)) {
+                    return false;
+                }
+                ++nextError;
+                continue;
+            }
+            records.append(chunk.at(i));
+            recordNumbers.append(firstRecord + i);
+        }
+
+        bool success = batch.renderRecords(records, [&](int index, const QImage &image) {
+            QString path = outputPathForRecord(recordNumbers.at(index));
+            QImage output = image;
+            if (m_depth == 8) {
+                output = MonoRenderer::toGrayscale(image);
+            } else if (m_depth == 1) {
+                output = MonoRenderer::toMono(image, threshold, ditherRegion);
+            }
+
+            return saveImage(output, path);
+        });
+
+        // 通过验证但仍无法应用的记录（例如编码器不支持）
+        for (const DataMergeEngine::RecordError &error : batch.invalidRecords()) {
+            if (!reportInvalidRecord(recordNumbers.at(error.record), error.errorString)) {
+                return false;
+            }
+        }
+
+        if (!success) {
+            return false;
+        }
+
+        firstRecord += chunk.size();
+    }
+
+    return true;
+}
+
+bool HeadlessRenderer::renderToPdf()
+{
+    QPrinter printer(QPrinter::HighResolution);
+    printer.setOutputFormat(QPrinter::PdfFormat);
+    printer.setOutputFileName(m_outputPath);
+    printer.setResolution(m_dpi);
+
+    // 页面尺寸已按方向调整，这里直接使用实际尺寸且不留打印边距
+    printer.setPageSize(QPageSize(m_document->pageRealSize(), QPageSize::Millimeter));
+    printer.setPageOrientation(QPageLayout::Portrait);
+    printer.setPageMargins(QMarginsF(0, 0, 0, 0), QPageLayout::Millimeter);
+
+    QFile dataFile(m_dataPath);
+    DataRecordReader reader(&dataFile);
+    DataMergeEngine engine;
+
+    if (!m_dataPath.isEmpty()) {
+        if (!dataFile.open(QFile::ReadOnly | QFile::Text)) {
+            qCritical() << "无法读取文件" << m_dataPath << ":" << dataFile.errorString();
+            return false;
+        }
+
+        if (!reader.readHeader()) {
+            qCritical() << "数据文件没有表头:" << m_dataPath;
+            return false;
+        }
+
+        engine.bind(m_document);
+        engine.setColumns(reader.columns());
+        if (!engine.missingColumns().isEmpty()) {
+            qWarning() << "数据文件缺少列:" << engine.missingColumns();
+        }
+    }
+
+    QPainter painter;
+    if (!painter.begin(&printer)) {
+        qCritical() << "无法写入文件:" << m_outputPath;
+        return false;
+    }
+
+    QRect pageRect = printer.pageLayout().paintRectPixels(printer.resolution());
+
+    if (m_dataPath.isEmpty()) {
+        m_document->render(&painter, pageRect);
+    } else {
+        // 每条有效记录输出一页
+        QStringList record;
+        QString errorString;
+        bool firstPage = true;
+        while (reader.readRecord(&record)) {
+            if (!engine.apply(record, &errorString)) {
+                if (!reportInvalidRecord(reader.recordCount(), errorString)) {
+                    painter.end();
+                    return false;
+                }
+                continue;
+            }
+
+            if (!firstPage) {
+                printer.newPage();
+            }
+            firstPage = false;
+
+            m_document->render(&painter, pageRect);
+        }
+    }
+
+    painter.end();
+
+    return true;
+}
+
+bool HeadlessRenderer::renderToZpl()
+{
+    ZplExporter exporter(m_document);
+    exporter.setResolution(m_dpi);
+
+    if (m_dataPath.isEmpty()) {
+        return exporter.exportToFile(m_outputPath);
+    }
+
+    QFile dataFile(m_dataPath);
+    if (!dataFile.open(QFile::ReadOnly | QFile::Text)) {
+        qCritical() << "无法读取文件" << m_dataPath << ":" << dataFile.errorString();
+        return false;
+    }
+
+    DataRecordReader reader(&dataFile);
+    if (!reader.readHeader()) {
+        qCritical() << "数据文件没有表头:" << m_dataPath;
+        return false;
+    }
+
+    DataMergeEngine engine(m_document);
+    engine.setColumns(reader.columns());
+    if (!engine.missingColumns().isEmpty()) {
+        qWarning() << "数据文件缺少列:" << engine.missingColumns();
+    }
+
+    QFile file(m_outputPath);
+    if (!file.open(QFile::WriteOnly)) {
+        qCritical() << "无法写入文件:" << m_outputPath;
+        return false;
+    }
+
+    // 每条有效记录一张标签，依次写入同一个指令流
+    QStringList record;
+    QString errorString;
+    while (reader.readRecord(&record)) {
+        if (!engine.apply(record, &errorString)) {
+            if (!reportInvalidRecord(reader.recordCount(), errorString)) {
+                return false;
+            }
+            continue;
+        }
+
+        if (file.write(exporter.exportLabel()) < 0) {
+            qCritical() << "无法写入文件:" << m_outputPath;
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,136 @@
+#ifndef HEADLESSRENDERER_H
+#define HEADLESSRENDERER_H
+
+#include <QString>
+#include <QStringList>
+#include <QSize>
+
+class LabelDocument;
+class QImage;
+
+/**
+ * @brief 无界面渲染器
+ *
+ * 命令行模式下加载标签文档并直接输出图像或PDF，
+ * 不创建主窗口、启动画面和应用程序设置。
+ *
+ * 用法：printer --render in.xml --out out.png|pdf|zpl [--dpi 300] [--depth 32|8|1]
+ *                [--data records.csv] [--threads N] [--qr-encoder libqrencode|builtin]
+ *
+ * 指定--data时按记录合并数据：PDF输出为每条记录一页，
+ * 位图输出为每条记录一个文件（文件名中的{n}替换为记录序号，
+ * 否则在后缀前追加序号），位图记录在多个线程上并行渲染。
+ *
+ * ZPL输出时所有记录依次写入同一个文件，每条记录一张标签。
+ *
+ * --depth指定位图的颜色深度：8为灰度（激光打印机），
+ * 1为单色（热敏打印机，图像元素区域使用抖动）。
+ *
+ * --qr-encoder builtin使用内置二维码编码器，适合大批量序列号二维码。
+ */
+class HeadlessRenderer
+{
+public:
+    /**
+     * @brief 构造函数
+     */
+    HeadlessRenderer();
+
+    /**
+     * @brief 析构函数
+     */
+    ~HeadlessRenderer();
+
+    /**
+     * @brief 判断命令行是否请求无界面渲染
+     *
+     * 在创建应用程序实例之前调用，以便选择offscreen平台插件
+     *
+     * @param argc 命令行参数数量
+     * @param argv 命令行参数数组
+     * @return 如果包含--render参数则返回true
+     */
+    static bool isRequested(int argc, char *argv[]);
+
+    /**
+     * @brief 执行渲染任务
+     * @param arguments 命令行参数（含程序名）
+     * @return 进程退出码，0表示成功
+     */
+    int run(const QStringList &arguments);
+
+private:
+    /**
+     * @brief 解析命令行参数
+     * @param arguments 命令行参数
+     * @return 参数是否有效
+     */
+    bool parseArguments(const QStringList &arguments);
+
+    /**
+     * @brief 加载输入文档
+     * @return 是否加载成功
+     */
+    bool loadDocument();
+
+    /**
+     * @brief 计算输出图像的像素尺寸
+     * @return 图像尺寸
+     */
+    QSize outputPixelSize() const;
+
+    /**
+     * @brief 获取指定记录的输出文件路径
+     * @param recordNumber 记录序号（从1开始），0表示不合并数据
+     * @return 文件路径
+     */
+    QString outputPathForRecord(int recordNumber) const;
+
+    /**
+     * @brief 保存位图文件
+     * @param image 图像
+     * @param path 文件路径
+     * @return 是否成功
+     */
+    bool saveImage(QImage &image, const QString &path) const;
+
+    /**
+     * @brief 报告无效记录
+     *
+     * 指定了--skip-invalid时输出警告并跳过该记录，否则输出错误并终止
+     *
+     * @param recordNumber 记录序号（从1开始）
+     * @param errorString 错误说明
+     * @return 是否继续处理其余记录
+     */
+    bool reportInvalidRecord(int recordNumber, const QString &errorString) const;
+
+    /**
+     * @brief 渲染为位图文件（PNG、BMP等）
+     * @return 是否成功
+     */
+    bool renderToImage();
+
+    /**
+     * @brief 渲染为PDF文件
+     * @return 是否成功
+     */
+    bool renderToPdf();
+
+    /**
+     * @brief 导出为ZPL打印机指令
+     * @return 是否成功
+     */
+    bool renderToZpl();
+
+    LabelDocument *m_document;  ///< 加载的文档
+    QString m_inputPath;        ///< 输入文件路径
+    QString m_outputPath;       ///< 输出文件路径
+    QString m_dataPath;         ///< 合并数据文件路径
+    int m_dpi;                  ///< 输出分辨率，0表示使用文档设置
+    int m_threadCount;          ///< 渲染线程数，0表示使用CPU核心数
+    int m_depth;                ///< 位图颜色深度（32、8或1）
+    bool m_skipInvalid;         ///< 是否跳过条形码数据无效的记录
+};
+
+#endif // HEADLESSRENDERER_H
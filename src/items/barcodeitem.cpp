@@ -9,6 +9,8 @@
 #include <QUuid>
 #include <QFontMetrics>
 
+#include <array>
+
 // ZXing库头文件
 #include <ZXing/MultiFormatWriter.h>
 #include <ZXing/BitMatrix.h>
@@ -45,34 +47,335 @@ static const QMap<BarcodeType, ZXing::BarcodeFormat> zxingFormatMap = {
     {BarcodeType::Codabar, ZXing::BarcodeFormat::CODABAR}
 };
 
-// 保留原始编码表，用于回退实现
-static const QList<QList<int>> code128Patterns = {
-    // Code 128 A 开始符
-    {2, 1, 1, 4, 1, 2},   // START A
-    // Code 128 B 开始符
-    {2, 1, 1, 2, 1, 4},   // START B
-    // Code 128 C 开始符
-    {2, 1, 1, 2, 3, 2},   // START C
-    // 停止符
-    {2, 3, 3, 1, 1, 1, 2} // STOP
+// 以下编译期模式表用于回退实现，图案按模块存放，高位在前
+
+/**
+ * @brief 单个字符的模块图案
+ */
+struct SymbolPattern
+{
+    quint16 bits;   ///< 模块图案，最低count位有效
+    quint8 count;   ///< 模块数
+};
+
+// 由宽度序列（条、空交替，如"212222"）生成模块图案
+static constexpr SymbolPattern widthsToPattern(const char *widths)
+{
+    SymbolPattern pattern = {0, 0};
+    bool bar = true;
+    for (const char *w = widths; *w; ++w) {
+        for (int i = 0; i < *w - '0'; ++i) {
+            pattern.bits = static_cast<quint16>((pattern.bits << 1) | (bar ? 1 : 0));
+            ++pattern.count;
+        }
+        bar = !bar;
+    }
+    return pattern;
+}
+
+// 由宽窄序列（条、空交替，n为1个模块，w为2个模块）生成模块图案
+static constexpr SymbolPattern elementsToPattern(const char *elements)
+{
+    SymbolPattern pattern = {0, 0};
+    bool bar = true;
+    for (const char *e = elements; *e; ++e) {
+        const int width = (*e == 'w') ? 2 : 1;
+        for (int i = 0; i < width; ++i) {
+            pattern.bits = static_cast<quint16>((pattern.bits << 1) | (bar ? 1 : 0));
+            ++pattern.count;
+        }
+        bar = !bar;
+    }
+    return pattern;
+}
+
+// Code 128 符号表，按符号值索引
+static constexpr SymbolPattern code128Patterns[] = {
+    widthsToPattern("212222"), widthsToPattern("222122"), widthsToPattern("222221"), widthsToPattern("121223"),
+    widthsToPattern("121322"), widthsToPattern("131222"), widthsToPattern("122213"), widthsToPattern("122312"),
+    widthsToPattern("132212"), widthsToPattern("221213"), widthsToPattern("221312"), widthsToPattern("231212"),
+    widthsToPattern("112232"), widthsToPattern("122132"), widthsToPattern("122231"), widthsToPattern("113222"),
+    widthsToPattern("123122"), widthsToPattern("123221"), widthsToPattern("223211"), widthsToPattern("221132"),
+    widthsToPattern("221231"), widthsToPattern("213212"), widthsToPattern("223112"), widthsToPattern("312131"),
+    widthsToPattern("311222"), widthsToPattern("321122"), widthsToPattern("321221"), widthsToPattern("312212"),
+    widthsToPattern("322112"), widthsToPattern("322211"), widthsToPattern("212123"), widthsToPattern("212321"),
+    widthsToPattern("232121"), widthsToPattern("111323"), widthsToPattern("131123"), widthsToPattern("131321"),
+    widthsToPattern("112313"), widthsToPattern("132113"), widthsToPattern("132311"), widthsToPattern("211313"),
+    widthsToPattern("231113"), widthsToPattern("231311"), widthsToPattern("112133"), widthsToPattern("112331"),
+    widthsToPattern("132131"), widthsToPattern("113123"), widthsToPattern("113321"), widthsToPattern("133121"),
+    widthsToPattern("313121"), widthsToPattern("211331"), widthsToPattern("231131"), widthsToPattern("213113"),
+    widthsToPattern("213311"), widthsToPattern("213131"), widthsToPattern("311123"), widthsToPattern("311321"),
+    widthsToPattern("331121"), widthsToPattern("312113"), widthsToPattern("312311"), widthsToPattern("332111"),
+    widthsToPattern("314111"), widthsToPattern("221411"), widthsToPattern("431111"), widthsToPattern("111224"),
+    widthsToPattern("111422"), widthsToPattern("121124"), widthsToPattern("121421"), widthsToPattern("141122"),
+    widthsToPattern("141221"), widthsToPattern("112214"), widthsToPattern("112412"), widthsToPattern("122114"),
+    widthsToPattern("122411"), widthsToPattern("142112"), widthsToPattern("142211"), widthsToPattern("241211"),
+    widthsToPattern("221114"), widthsToPattern("413111"), widthsToPattern("241112"), widthsToPattern("134111"),
+    widthsToPattern("111242"), widthsToPattern("121142"), widthsToPattern("121241"), widthsToPattern("114212"),
+    widthsToPattern("124112"), widthsToPattern("124211"), widthsToPattern("411212"), widthsToPattern("421112"),
+    widthsToPattern("421211"), widthsToPattern("212141"), widthsToPattern("214121"), widthsToPattern("412121"),
+    widthsToPattern("111143"), widthsToPattern("111341"), widthsToPattern("131141"), widthsToPattern("114113"),
+    widthsToPattern("114311"), widthsToPattern("411113"), widthsToPattern("411311"), widthsToPattern("113141"),
+    widthsToPattern("114131"), widthsToPattern("311141"), widthsToPattern("411131"), widthsToPattern("211412"),
+    widthsToPattern("211214"), widthsToPattern("211232"), widthsToPattern("2331112")
+};
+
+static constexpr int CODE128_START_B = 104;    // Code 128 B 开始符
+static constexpr int CODE128_STOP = 106;       // 停止符
+
+// Code 39 字符集，字符的位置即校验计算中的字符值，'*'为开始/结束符
+static constexpr char code39Charset[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ-. $/+%*";
+
+// Code 39 符号表，与字符集一一对应
+static constexpr SymbolPattern code39Patterns[] = {
+    elementsToPattern("nnnwwnwnn"), elementsToPattern("wnnwnnnnw"), elementsToPattern("nnwwnnnnw"),
+    elementsToPattern("wnwwnnnnn"), elementsToPattern("nnnwwnnnw"), elementsToPattern("wnnwwnnnn"),
+    elementsToPattern("nnwwwnnnn"), elementsToPattern("nnnwnnwnw"), elementsToPattern("wnnwnnwnn"),
+    elementsToPattern("nnwwnnwnn"), elementsToPattern("wnnnnwnnw"), elementsToPattern("nnwnnwnnw"),
+    elementsToPattern("wnwnnwnnn"), elementsToPattern("nnnnwwnnw"), elementsToPattern("wnnnwwnnn"),
+    elementsToPattern("nnwnwwnnn"), elementsToPattern("nnnnnwwnw"), elementsToPattern("wnnnnwwnn"),
+    elementsToPattern("nnwnnwwnn"), elementsToPattern("nnnnwwwnn"), elementsToPattern("wnnnnnnww"),
+    elementsToPattern("nnwnnnnww"), elementsToPattern("wnwnnnnwn"), elementsToPattern("nnnnwnnww"),
+    elementsToPattern("wnnnwnnwn"), elementsToPattern("nnwnwnnwn"), elementsToPattern("nnnnnnwww"),
+    elementsToPattern("wnnnnnwwn"), elementsToPattern("nnwnnnwwn"), elementsToPattern("nnnnwnwwn"),
+    elementsToPattern("wwnnnnnnw"), elementsToPattern("nwwnnnnnw"), elementsToPattern("wwwnnnnnn"),
+    elementsToPattern("nwnnwnnnw"), elementsToPattern("wwnnwnnnn"), elementsToPattern("nwwnwnnnn"),
+    elementsToPattern("nwnnnnwnw"), elementsToPattern("wwnnnnwnn"), elementsToPattern("nwwnnnwnn"),
+    elementsToPattern("nwnwnwnnn"), elementsToPattern("nwnwnnnwn"), elementsToPattern("nwnnnwnwn"),
+    elementsToPattern("nnnwnwnwn"), elementsToPattern("nwnnwnwnn")
 };
 
-// Code 39 字符集和编码
-static const QMap<QChar, QString> code39Patterns = {
-    {'0', "bwbwwwbwwb"}, {'1', "wwbwbwbwwb"}, {'2', "bwbwbwbwww"},
-    {'3', "wwbwbwbwww"}, {'4', "bwwwbwbwwb"}, {'5', "wwwwbwbwwb"},
-    {'6', "bwwwbwbwww"}, {'7', "bwwwwwbwwb"}, {'8', "wwwwwwbwwb"},
-    {'9', "bwwwwwbwww"}, {'A', "wwbwwwbwwb"}, {'B', "bwbwwwbwww"},
-    {'C', "wwbwwwbwww"}, {'D', "bwwwbwwwwb"}, {'E', "wwwwbwwwwb"},
-    {'F', "bwwwbwwwww"}, {'G', "bwwwwwbwwb"}, {'H', "wwwwwwbwwb"},
-    {'I', "bwwwwwbwww"}, {'J', "wwwwbwwwww"}, {'K', "wwbwwwwwbw"},
-    {'L', "bwbwwwwwbw"}, {'M', "wwbwwwwwbw"}, {'N', "bwwwbwwwbw"},
-    {'O', "wwwwbwwwbw"}, {'P', "bwwwbwwwbw"}, {'Q', "bwwwwwbwbw"},
-    {'R', "wwwwwwbwbw"}, {'S', "bwwwwwbwbw"}, {'T', "wwwwbwwwbw"},
-    {'U', "wwbwwwbwbw"}, {'V', "bwbwwwbwbw"}, {'W', "wwbwwwbwbw"},
-    {'X', "bwwwbwbwbw"}, {'Y', "wwwwbwbwbw"}, {'Z', "bwwwbwbwbw"},
-    {'-', "bwwwwwbwbw"}, {'.', "wwwwwwbwbw"}, {' ', "bwwwbwbwbw"},
-    {'*', "bwwwbwbwb"}   // 开始/结束符
+static_assert(sizeof(code39Patterns) / sizeof(SymbolPattern) == sizeof(code39Charset) - 1,
+              "Code 39 符号表与字符集长度不一致");
+
+static constexpr int CODE39_START_STOP = 43;   // '*'的字符值
+
+// 生成ASCII到Code 39字符值的索引表，不支持的字符为-1
+static constexpr std::array<qint8, 128> makeCode39Values()
+{
+    std::array<qint8, 128> values = {};
+    for (int i = 0; i < 128; ++i) {
+        values[i] = -1;
+    }
+    for (int i = 0; code39Charset[i]; ++i) {
+        values[static_cast<int>(code39Charset[i])] = static_cast<qint8>(i);
+    }
+    return values;
+}
+
+static constexpr std::array<qint8, 128> code39Values = makeCode39Values();
+
+// 获取Code 39字符值，不支持的字符返回-1
+static inline int code39Value(QChar c)
+{
+    const ushort code = c.unicode();
+    return code < 128 ? code39Values[code] : -1;
+}
+
+// EAN/UPC 左侧奇校验（L）编码，按数字索引，7个模块
+static constexpr quint8 eanLPatterns[10] = {
+    0x0D, 0x19, 0x13, 0x3D, 0x23, 0x31, 0x2F, 0x3B, 0x37, 0x0B
+};
+
+// 右侧（R）编码为L编码取反
+static constexpr quint8 eanRPattern(int digit)
+{
+    return static_cast<quint8>(eanLPatterns[digit] ^ 0x7F);
+}
+
+// 左侧偶校验（G）编码为R编码左右翻转
+static constexpr quint8 eanGPattern(int digit)
+{
+    quint8 reversed = 0;
+    for (int i = 0; i < 7; ++i) {
+        reversed = static_cast<quint8>((reversed << 1) | ((eanRPattern(digit) >> i) & 1));
+    }
+    return reversed;
+}
+
+// EAN-13 左侧6位的奇偶组合，由第一位数字决定（1为G编码，高位对应第二位数字）
+static constexpr quint8 ean13Parity[10] = {
+    0x00, 0x0B, 0x0D, 0x0E, 0x13, 0x19, 0x1C, 0x15, 0x16, 0x1A
+};
+
+// Interleaved 2 of 5 数字编码，5个单元中的宽单元（高位在前）
+static constexpr quint8 itfWidePatterns[10] = {
+    0x06, 0x11, 0x09, 0x18, 0x05, 0x14, 0x0C, 0x03, 0x12, 0x0A
+};
+
+static constexpr int ITF_WIDE = 3;              // 宽单元的模块数
+
+// 获取数字值，非数字返回-1
+static inline int digitAt(const QString &data, int index)
+{
+    const ushort code = data.at(index).unicode();
+    return (code >= '0' && code <= '9') ? code - '0' : -1;
+}
+
+// 判断是否全部为数字
+static bool isAllDigits(const QString &data)
+{
+    for (int i = 0; i < data.length(); ++i) {
+        if (digitAt(data, i) < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 追加一个字符的模块图案
+static inline void appendPattern(BarcodeModules *modules, const SymbolPattern &pattern)
+{
+    modules->appendBits(pattern.bits, pattern.count);
+}
+
+/**
+ * @brief 回退编码器，按条形码类型特化
+ *
+ * ZXing无法生成时使用。内层循环只有查表和写位，不分配内存；
+ * 数据无效时返回false且不修改输出。
+ */
+template <BarcodeType Type>
+struct FallbackEncoder;
+
+template <>
+struct FallbackEncoder<BarcodeType::Code128>
+{
+    // Code 128 B：开始符、数据、模103校验符、停止符
+    static bool encode(const QString &data, bool /*includeChecksum*/, BarcodeModules *modules)
+    {
+        for (QChar c : data) {
+            if (c.unicode() < 32 || c.unicode() > 126) {
+                return false;
+            }
+        }
+
+        modules->reserve(modules->size() + (data.length() + 3) * 11 + 2);
+        appendPattern(modules, code128Patterns[CODE128_START_B]);
+
+        int checksum = CODE128_START_B;
+        for (int i = 0; i < data.length(); ++i) {
+            const int value = data.at(i).unicode() - 32;
+            appendPattern(modules, code128Patterns[value]);
+            checksum += value * (i + 1);
+        }
+
+        appendPattern(modules, code128Patterns[checksum % 103]);
+        appendPattern(modules, code128Patterns[CODE128_STOP]);
+        return true;
+    }
+};
+
+template <>
+struct FallbackEncoder<BarcodeType::Code39>
+{
+    // data已包含开始/结束符'*'；校验符为字符值之和模43，位于结束符之前
+    static bool encode(const QString &data, bool includeChecksum, BarcodeModules *modules)
+    {
+        int sum = 0;
+        for (int i = 0; i < data.length(); ++i) {
+            const int value = code39Value(data.at(i));
+            if (value < 0) {
+                return false;
+            }
+            if (i > 0 && i < data.length() - 1) {
+                sum += value;
+            }
+        }
+
+        modules->reserve(modules->size() + (data.length() + 1) * 13);
+        for (int i = 0; i < data.length(); ++i) {
+            if (includeChecksum && i == data.length() - 1) {
+                appendCharacter(modules, sum % 43);
+            }
+            appendCharacter(modules, code39Value(data.at(i)));
+        }
+        return true;
+    }
+
+    // 字符之间以一个窄空分隔
+    static void appendCharacter(BarcodeModules *modules, int value)
+    {
+        appendPattern(modules, code39Patterns[value]);
+        modules->append(false);
+    }
+};
+
+template <>
+struct FallbackEncoder<BarcodeType::EAN8>
+{
+    // data为含校验位的8位数字
+    static bool encode(const QString &data, bool /*includeChecksum*/, BarcodeModules *modules)
+    {
+        if (data.length() != 8 || !isAllDigits(data)) {
+            return false;
+        }
+
+        modules->reserve(modules->size() + 67);
+        modules->appendBits(0x5, 3);        // 起始模式 101
+        for (int i = 0; i < 4; ++i) {
+            modules->appendBits(eanLPatterns[digitAt(data, i)], 7);
+        }
+        modules->appendBits(0xA, 5);        // 中间模式 01010
+        for (int i = 4; i < 8; ++i) {
+            modules->appendBits(eanRPattern(digitAt(data, i)), 7);
+        }
+        modules->appendBits(0x5, 3);        // 结束模式 101
+        return true;
+    }
+};
+
+template <>
+struct FallbackEncoder<BarcodeType::EAN13>
+{
+    // data为含校验位的13位数字，第一位由左侧的奇偶组合隐含表示
+    static bool encode(const QString &data, bool /*includeChecksum*/, BarcodeModules *modules)
+    {
+        if (data.length() != 13 || !isAllDigits(data)) {
+            return false;
+        }
+
+        const quint8 parity = ean13Parity[digitAt(data, 0)];
+
+        modules->reserve(modules->size() + 95);
+        modules->appendBits(0x5, 3);        // 起始模式 101
+        for (int i = 1; i < 7; ++i) {
+            const int digit = digitAt(data, i);
+            const bool even = (parity >> (6 - i)) & 1;
+            modules->appendBits(even ? eanGPattern(digit) : eanLPatterns[digit], 7);
+        }
+        modules->appendBits(0xA, 5);        // 中间模式 01010
+        for (int i = 7; i < 13; ++i) {
+            modules->appendBits(eanRPattern(digitAt(data, i)), 7);
+        }
+        modules->appendBits(0x5, 3);        // 结束模式 101
+        return true;
+    }
+};
+
+template <>
+struct FallbackEncoder<BarcodeType::Interleaved2of5>
+{
+    // data为偶数位数字（已含校验位），每对数字的前一位编码为条，后一位编码为空
+    static bool encode(const QString &data, bool /*includeChecksum*/, BarcodeModules *modules)
+    {
+        if (data.length() % 2 != 0 || !isAllDigits(data)) {
+            return false;
+        }
+
+        modules->reserve(modules->size() + data.length() * 9 + 9);
+        modules->appendBits(0xA, 4);        // 起始符 1010
+        for (int i = 0; i < data.length(); i += 2) {
+            const quint8 bars = itfWidePatterns[digitAt(data, i)];
+            const quint8 spaces = itfWidePatterns[digitAt(data, i + 1)];
+            for (int k = 4; k >= 0; --k) {
+                modules->appendRun(true, ((bars >> k) & 1) ? ITF_WIDE : 1);
+                modules->appendRun(false, ((spaces >> k) & 1) ? ITF_WIDE : 1);
+            }
+        }
+        modules->appendBits(0x1D, 5);       // 结束符 11101
+        return true;
+    }
 };
 
 BarcodeItem::BarcodeItem(QGraphicsItem *parent)
@@ -85,6 +388,7 @@ BarcodeItem::BarcodeItem(QGraphicsItem *parent)
     , m_textFont(QFont("Arial", 8))
     , m_margin(10)
     , m_includeChecksum(true)
+    , m_targetDpi(0)
 {
     // 设置元素类型
     setFlag(QGraphicsItem::ItemIsSelectable, true);
@@ -95,8 +399,8 @@ BarcodeItem::BarcodeItem(QGraphicsItem *parent)
     // 设置默认大小
     setSize(QSizeF(200, 100));
 
-    // 生成条形码图像
-    generateBarcodeImage();
+    // 标记条形码图像需要重新生成
+    invalidateContent();
 }
 
 BarcodeItem::BarcodeItem(const QString &data, BarcodeType type, QGraphicsItem *parent)
@@ -106,7 +410,7 @@ BarcodeItem::BarcodeItem(const QString &data, BarcodeType type, QGraphicsItem *p
     m_type = type;
 
     // 更新条形码内容
-    updateContent();
+    invalidateContent();
 }
 
 BarcodeItem::~BarcodeItem()
@@ -130,10 +434,8 @@ void BarcodeItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *optio
     // 绘制背景
     painter->fillRect(m_rect, m_backgroundColor);
 
-    // 如果有条形码图像，绘制图像
-    if (!m_barcodeImage.isNull()) {
-        painter->drawImage(m_rect, m_barcodeImage, m_barcodeImage.rect());
-    } else {
+    // 直接绘制条，任意缩放和打印分辨率下都清晰
+    if (!paintVector(painter)) {
         // 没有条形码时绘制占位符
         painter->setPen(Qt::gray);
         painter->setBrush(Qt::lightGray);
@@ -224,8 +526,8 @@ bool BarcodeItem::loadFromXml(const QDomElement &element)
         m_textFont.setItalic(italic);
     }
 
-    // 生成条形码图像
-    generateBarcodeImage();
+    // 标记条形码图像需要重新生成
+    invalidateContent();
 
     return true;
 }
@@ -310,8 +612,8 @@ bool BarcodeItem::fromJson(const QJsonObject &json)
         m_textFont.setItalic(italic);
     }
 
-    // 生成条形码图像
-    generateBarcodeImage();
+    // 标记条形码图像需要重新生成
+    invalidateContent();
 
     return true;
 }
@@ -337,17 +639,18 @@ LabelItem* BarcodeItem::clone() const
     clone->m_textFont = m_textFont;
     clone->m_margin = m_margin;
     clone->m_includeChecksum = m_includeChecksum;
+    clone->m_targetDpi = m_targetDpi;
 
-    // 生成条形码图像
-    clone->generateBarcodeImage();
+    // 内容在下一次事件循环或首次绘制时生成
+    clone->invalidateContent();
 
     return clone;
 }
 
 void BarcodeItem::updateContent()
 {
-    // 生成条形码图像
-    generateBarcodeImage();
+    // 重新编码条形码
+    updateSymbol();
 
     // 更新视图
     update();
@@ -359,14 +662,14 @@ void BarcodeItem::setData(const QString &data)
         return;
     }
 
-    // 验证数据有效性
-    if (!validateData(data, m_type)) {
+    // 验证数据有效性（模板在合并时验证）
+    if (!isTemplateData(data) && !validateData(data, m_type)) {
         qWarning() << "无效的条形码数据:" << data << "对于类型:" << getTypeName(m_type);
         return;
     }
 
     m_data = data;
-    generateBarcodeImage();
+    invalidateContent();
     setModified(true);
     emit dataChanged(data);
     emit itemChanged();
@@ -385,8 +688,8 @@ void BarcodeItem::setType(BarcodeType type)
 
     m_type = type;
 
-    // 验证当前数据对于新类型是否有效
-    if (!validateData(m_data, m_type)) {
+    // 验证当前数据对于新类型是否有效（保留模板）
+    if (!isTemplateData(m_data) && !validateData(m_data, m_type)) {
         // 如果无效，设置默认数据
         switch (m_type) {
             case BarcodeType::EAN8:
@@ -407,7 +710,7 @@ void BarcodeItem::setType(BarcodeType type)
         }
     }
 
-    generateBarcodeImage();
+    invalidateContent();
     setModified(true);
     emit typeChanged(type);
     emit itemChanged();
@@ -425,7 +728,7 @@ void BarcodeItem::setForegroundColor(const QColor &color)
     }
 
     m_foregroundColor = color;
-    generateBarcodeImage();
+    invalidateContent();
     setModified(true);
     emit foregroundColorChanged(color);
     emit itemChanged();
@@ -443,7 +746,7 @@ void BarcodeItem::setBackgroundColor(const QColor &color)
     }
 
     m_backgroundColor = color;
-    generateBarcodeImage();
+    invalidateContent();
     setModified(true);
     emit backgroundColorChanged(color);
     emit itemChanged();
@@ -461,7 +764,7 @@ void BarcodeItem::setShowText(bool show)
     }
 
     m_showText = show;
-    generateBarcodeImage();
+    invalidateContent();
     setModified(true);
     emit showTextChanged(show);
     emit itemChanged();
@@ -479,7 +782,7 @@ void BarcodeItem::setTextFont(const QFont &font)
     }
 
     m_textFont = font;
-    generateBarcodeImage();
+    invalidateContent();
     setModified(true);
     emit textFontChanged(font);
     emit itemChanged();
@@ -497,7 +800,7 @@ void BarcodeItem::setMargin(int margin)
     }
 
     m_margin = margin;
-    generateBarcodeImage();
+    invalidateContent();
     setModified(true);
     emit marginChanged(margin);
     emit itemChanged();
@@ -543,7 +846,7 @@ void BarcodeItem::setIncludeChecksum(bool include)
     }
 
     m_includeChecksum = include;
-    generateBarcodeImage();
+    invalidateContent();
     setModified(true);
     emit includeChecksumChanged(include);
     emit itemChanged();
@@ -554,6 +857,21 @@ bool BarcodeItem::includeChecksum() const
     return m_includeChecksum;
 }
 
+void BarcodeItem::setTargetDpi(int dpi)
+{
+    if (m_targetDpi == dpi) {
+        return;
+    }
+
+    m_targetDpi = qMax(0, dpi);
+    update();
+}
+
+int BarcodeItem::targetDpi() const
+{
+    return m_targetDpi;
+}
+
 QString BarcodeItem::getTypeName(BarcodeType type)
 {
     return barcodeTypeNames.value(type, "Code 128");
@@ -605,7 +923,7 @@ bool BarcodeItem::validateData(const QString &data, BarcodeType type)
         case BarcodeType::Code39:
             // Code 39 只能包含大写字母、数字和特定符号
             for (QChar c : data) {
-                if (!code39Patterns.contains(c) && c != '*') {
+                if (code39Value(c) < 0) {
                     return false;
                 }
             }
@@ -667,161 +985,217 @@ bool BarcodeItem::validateData(const QString &data, BarcodeType type)
     }
 }
 
-QImage BarcodeItem::generateBarcode(const QString &data, BarcodeType type,
-                                   int width, int height,
-                                   const QColor &foreground,
-                                   const QColor &background,
-                                   bool includeText,
-                                   const QFont &textFont,
-                                   int margin,
-                                   bool includeChecksum)
+bool BarcodeItem::isTemplateData(const QString &data)
 {
-    // 创建图像
-    QImage image(width, height, QImage::Format_ARGB32);
-    image.fill(background);
-
-    // 尝试使用ZXing生成条形码
-    try {
-        if (zxingFormatMap.contains(type)) {
-            // 计算文本高度（如果显示文本）
-            int textHeight = 0;
-            if (includeText) {
-                QFontMetrics fm(textFont);
-                textHeight = fm.height() + 4; // 添加一些间距
-            }
+    const int begin = data.indexOf(QLatin1String("{{"));
+    return begin >= 0 && data.indexOf(QLatin1String("}}"), begin + 2) >= 0;
+}
 
-            // 计算条形码高度
-            int barcodeHeight = height - margin * 2 - textHeight;
-            int barcodeWidth = width - margin * 2;
+int BarcodeItem::moduleCount(const QString &data, BarcodeType type)
+{
+    return BarcodeSymbol::encode(data, type).moduleCount();
+}
 
-            if (barcodeHeight <= 0 || barcodeWidth <= 0) {
-                return image; // 空间太小，无法生成
-            }
+BarcodeSymbol BarcodeItem::symbol() const
+{
+    flushContent();
+    return m_symbol;
+}
 
-            // 根据条形码类型选择格式
-            ZXing::BarcodeFormat format = zxingFormatMap.value(type);
+BarcodeModules BarcodeItem::encodePattern(const QString &data, BarcodeType type, bool includeChecksum,
+                                          bool *fallback)
+{
+    const BarcodeModules pattern = encodeZXing(data, type);
+    if (fallback) {
+        *fallback = pattern.isEmpty();
+    }
+    if (!pattern.isEmpty()) {
+        return pattern;
+    }
 
-            // 设置编码选项
-            ZXing::MultiFormatWriter writer;
+    // ZXing不支持或生成失败时使用内置编码器
+    return encodeFallback(data, type, includeChecksum);
+}
 
-            // 对于需要校验位的类型，确保数据格式正确
-            std::string content = data.toStdString();
+BarcodeModules BarcodeItem::encodeZXing(const QString &data, BarcodeType type)
+{
+    BarcodeModules pattern;
 
-            // 生成条形码矩阵
-            auto matrix = writer.encode(content, barcodeWidth, barcodeHeight, format);
-
-            // 绘制条形码
-            QPainter painter(&image);
-            painter.setPen(Qt::NoPen);
-            painter.setBrush(foreground);
-
-            // 计算条形码实际绘制区域
-            qreal scaleX = (qreal)barcodeWidth / matrix.width();
-            qreal scaleY = (qreal)barcodeHeight / matrix.height();
-
-            for (int y = 0; y < matrix.height(); ++y) {
-                for (int x = 0; x < matrix.width(); ++x) {
-                    if (matrix.get(x, y)) {
-                        QRectF rect(margin + x * scaleX,
-                                    margin + y * scaleY,
-                                    scaleX, scaleY);
-                        painter.drawRect(rect);
-                    }
-                }
-            }
+    try {
+        if (zxingFormatMap.contains(type)) {
+            // 宽度为0时ZXing输出最小尺寸，每个模块一列；
+            // 不要默认静区，与内置编码器一致，ZPL导出按模块数换算的条宽也与屏幕相同
+            ZXing::MultiFormatWriter writer;
+            writer.setMargin(0);
+            auto matrix = writer.encode(data.toStdString(), 0, 1, zxingFormatMap.value(type));
 
-            // 绘制文本
-            if (includeText) {
-                painter.setPen(foreground);
-                painter.setFont(textFont);
-                painter.drawText(QRect(margin, margin + barcodeHeight,
-                                       barcodeWidth, textHeight),
-                                Qt::AlignCenter, data);
+            pattern.reserve(matrix.width());
+            for (int x = 0; x < matrix.width(); ++x) {
+                pattern.append(matrix.get(x, 0));
             }
 
-            return image;
+            return pattern;
         }
     }
     catch (const std::exception &e) {
         qWarning() << "ZXing条形码生成错误:" << e.what();
-        // 如果ZXing生成失败，继续使用原始方法
     }
 
-    // 以下是原始的生成方法（回退方案）
-    QPainter painter(&image);
-
-    // 设置抗锯齿
-    painter.setRenderHint(QPainter::Antialiasing);
-    painter.setRenderHint(QPainter::TextAntialiasing);
+    return BarcodeModules();
+}
 
-    // 计算文本高度（如果显示文本）
-    int textHeight = 0;
-    if (includeText) {
-        QFontMetrics fm(textFont);
-        textHeight = fm.height() + 4; // 添加一些间距
+bool BarcodeItem::hasFallbackEncoder(BarcodeType type)
+{
+    switch (type) {
+        case BarcodeType::Code128:
+        case BarcodeType::Code39:
+        case BarcodeType::EAN8:
+        case BarcodeType::EAN13:
+        case BarcodeType::UPC_A:
+        case BarcodeType::Interleaved2of5:
+            return true;
+        default:
+            return false;
     }
+}
 
-    // 计算条形码高度
-    int barcodeHeight = height - margin * 2 - textHeight;
-
-    // 根据条形码类型生成编码
-    QList<bool> barcode;
-    int barWidth = width - margin * 2;
+BarcodeModules BarcodeItem::encodeFallback(const QString &data, BarcodeType type, bool includeChecksum)
+{
+    BarcodeModules modules;
+    QString codeData = data;
 
     switch (type) {
-        case BarcodeType::Code128:
-            barcode = encodeCode128(data, barWidth, barcodeHeight, includeText, textFont, margin);
-            break;
-
         case BarcodeType::Code39:
-            barcode = encodeCode39(data, barWidth, barcodeHeight, includeText, textFont, margin, includeChecksum);
+            // 如果数据不以*开始和结束，添加*作为开始/结束符
+            if (!codeData.startsWith('*')) {
+                codeData = '*' + codeData;
+            }
+            if (!codeData.endsWith('*')) {
+                codeData = codeData + '*';
+            }
+
+            // 需要时在结束符之前插入模43校验符
+            FallbackEncoder<BarcodeType::Code39>::encode(codeData, includeChecksum, &modules);
             break;
 
         case BarcodeType::EAN8:
-            barcode = encodeEAN8(data, barWidth, barcodeHeight, includeText, textFont, margin);
+            // 确保数据长度为7位（不含校验位），再补上校验位
+            if (codeData.length() < 7) {
+                codeData = codeData.rightJustified(7, '0');
+            } else if (codeData.length() > 7) {
+                codeData = codeData.left(7);
+            }
+            codeData += QString::number(calculateEANChecksum(codeData));
+
+            FallbackEncoder<BarcodeType::EAN8>::encode(codeData, false, &modules);
             break;
 
         case BarcodeType::EAN13:
-            barcode = encodeEAN13(data, barWidth, barcodeHeight, includeText, textFont, margin);
+            // 确保数据长度为12位（不含校验位），再补上校验位
+            if (codeData.length() < 12) {
+                codeData = codeData.rightJustified(12, '0');
+            } else if (codeData.length() > 12) {
+                codeData = codeData.left(12);
+            }
+            codeData += QString::number(calculateEANChecksum(codeData));
+
+            FallbackEncoder<BarcodeType::EAN13>::encode(codeData, false, &modules);
             break;
 
         case BarcodeType::UPC_A:
-            barcode = encodeUPC_A(data, barWidth, barcodeHeight, includeText, textFont, margin);
-            break;
+            // 对于UPC-A，我们可以使用EAN-13编码并在前面添加0
+            return encodeFallback("0" + data, BarcodeType::EAN13, false);
 
         case BarcodeType::Interleaved2of5:
-            barcode = encodeInterleaved2of5(data, barWidth, barcodeHeight, includeText, textFont, margin, includeChecksum);
+            // Interleaved 2 of 5需要偶数位数字
+            if (codeData.length() % 2 != 0) {
+                codeData = "0" + codeData;
+            }
+
+            if (includeChecksum) {
+                // 加上校验位后仍为偶数位
+                codeData = "0" + codeData;
+
+                int sum = 0;
+                for (int i = 0; i < codeData.length(); ++i) {
+                    // 奇数位置乘以3，偶数位置乘以1
+                    sum += codeData.at(i).digitValue() * (i % 2 == 0 ? 3 : 1);
+                }
+                codeData += QString::number((10 - (sum % 10)) % 10);
+            }
+
+            FallbackEncoder<BarcodeType::Interleaved2of5>::encode(codeData, includeChecksum, &modules);
             break;
 
         // 其他条形码类型的编码...
         default:
             // 默认使用Code 128
-            barcode = encodeCode128(data,barWidth, barcodeHeight, includeText, textFont, margin);
+            FallbackEncoder<BarcodeType::Code128>::encode(data, false, &modules);
             break;
     }
 
-    // 绘制条形码
-    if (!barcode.isEmpty()) {
-        int moduleWidth = barWidth / barcode.size();
-        if (moduleWidth < 1) moduleWidth = 1;
+    return modules;
+}
 
-        painter.setPen(Qt::NoPen);
-        painter.setBrush(foreground);
+QImage BarcodeItem::generateBarcode(const QString &data, BarcodeType type,
+                                   int width, int height,
+                                   const QColor &foreground,
+                                   const QColor &background,
+                                   bool includeText,
+                                   const QFont &textFont,
+                                   int margin,
+                                   bool includeChecksum)
+{
+    // 编码结果来自全局缓存，只改颜色、字体或尺寸时不会重新编码
+    return renderImage(BarcodeSymbol::encode(data, type, includeChecksum), width, height,
+                       foreground, background, includeText, textFont, margin);
+}
 
-        for (int i = 0; i < barcode.size(); ++i) {
-            if (barcode[i]) {
-                painter.drawRect(margin + i * moduleWidth, margin,
-                                moduleWidth, barcodeHeight);
-            }
-        }
+QImage BarcodeItem::renderImage(const BarcodeSymbol &symbol, int width, int height,
+                                const QColor &foreground, const QColor &background,
+                                bool includeText, const QFont &textFont, int margin)
+{
+    // 创建图像
+    QImage image(width, height, QImage::Format_ARGB32);
+    image.fill(background);
 
-        // 绘制文本
-        if (includeText) {
-            painter.setPen(foreground);
-            painter.setFont(textFont);
-            painter.drawText(QRect(margin, margin + barcodeHeight, width - margin * 2, textHeight),
-                           Qt::AlignCenter, data);
-        }
+    // 计算文本高度（如果显示文本）
+    int textHeight = 0;
+    if (includeText) {
+        QFontMetrics fm(textFont);
+        textHeight = fm.height() + 4; // 添加一些间距
+    }
+
+    // 计算条形码高度
+    int barcodeHeight = height - margin * 2 - textHeight;
+    int barcodeWidth = width - margin * 2;
+
+    if (barcodeHeight <= 0 || barcodeWidth <= 0 || !symbol.isValid()) {
+        return image; // 空间太小或无法编码
+    }
+
+    // 条的颜色按背景合成一次，与QPainter绘制半透明前景的结果一致
+    QRgb barColor = foreground.rgba();
+    if (foreground.alpha() != 255) {
+        QImage pixel(1, 1, QImage::Format_ARGB32);
+        pixel.fill(background);
+        QPainter blender(&pixel);
+        blender.fillRect(pixel.rect(), foreground);
+        blender.end();
+        barColor = pixel.pixel(0, 0);
+    }
+
+    // 绘制条形码
+    symbol.rasterize(&image, QRect(margin, margin, barcodeWidth, barcodeHeight), barColor);
+
+    // 绘制文本
+    if (includeText) {
+        QPainter painter(&image);
+        painter.setPen(foreground);
+        painter.setFont(textFont);
+        painter.drawText(QRect(margin, margin + barcodeHeight,
+                               barcodeWidth, textHeight),
+                        Qt::AlignCenter, symbol.text());
     }
 
     return image;
@@ -836,7 +1210,7 @@ void BarcodeItem::mouseDoubleClickEvent(QGraphicsSceneMouseEvent *event)
                                                tr("条形码数据:"), QLineEdit::Normal,
                                                m_data, &ok);
         if (ok && !newData.isEmpty()) {
-            if (validateData(newData, m_type)) {
+            if (isTemplateData(newData) || validateData(newData, m_type)) {
                 setData(newData);
             } else {
                 QInputDialog::warning(nullptr, tr("无效数据"),
@@ -850,564 +1224,62 @@ void BarcodeItem::mouseDoubleClickEvent(QGraphicsSceneMouseEvent *event)
     }
 }
 
-bool BarcodeItem::generateBarcodeImage()
+bool BarcodeItem::updateSymbol()
 {
-    // 确保数据和尺寸有效
-    if (m_data.isEmpty() || m_rect.width() < 10 || m_rect.height() < 10) {
-        m_barcodeImage = QImage();
-        return false;
-    }
+    // 编码一次，屏幕、打印和导出共用；条在绘制时直接生成，不缓存图像
+    m_symbol = BarcodeSymbol::encode(m_data, m_type, m_includeChecksum);
 
-    try {
-        // 尝试使用ZXing生成条形码
-        if (zxingFormatMap.contains(m_type)) {
-            int width = m_rect.width();
-            int height = m_rect.height();
-
-            // 计算文本高度（如果显示文本）
-            int textHeight = 0;
-            if (m_showText) {
-                QFontMetrics fm(m_textFont);
-                textHeight = fm.height() + 4; // 添加一些间距
-            }
-
-            // 计算条形码高度
-            int barcodeHeight = height - m_margin * 2 - textHeight;
-            int barcodeWidth = width - m_margin * 2;
-
-            if (barcodeHeight <= 0 || barcodeWidth <= 0) {
-                throw std::runtime_error("条形码尺寸太小");
-            }
-
-            // 创建图像
-            QImage image(width, height, QImage::Format_ARGB32);
-            image.fill(m_backgroundColor);
-
-            // 根据条形码类型选择格式
-            ZXing::BarcodeFormat format = zxingFormatMap.value(m_type);
-
-            // 设置编码选项
-            ZXing::MultiFormatWriter writer;
-            std::string content = m_data.toStdString();
-
-            // 生成条形码矩阵
-            auto matrix = writer.encode(content, barcodeWidth, barcodeHeight, format);
-
-            // 绘制条形码
-            QPainter painter(&image);
-            painter.setPen(Qt::NoPen);
-            painter.setBrush(m_foregroundColor);
-
-            // 计算条形码实际绘制区域
-            qreal scaleX = (qreal)barcodeWidth / matrix.width();
-            qreal scaleY = (qreal)barcodeHeight / matrix.height();
-
-            for (int y = 0; y < matrix.height(); ++y) {
-                for (int x = 0; x < matrix.width(); ++x) {
-                    if (matrix.get(x, y)) {
-                        QRectF rect(m_margin + x * scaleX,
-                                    m_margin + y * scaleY,
-                                    scaleX, scaleY);
-                        painter.drawRect(rect);
-                    }
-                }
-            }
-
-            // 绘制文本
-            if (m_showText) {
-                painter.setPen(m_foregroundColor);
-                painter.setFont(m_textFont);
-                painter.drawText(QRect(m_margin, m_margin + barcodeHeight,
-                                       barcodeWidth, textHeight),
-                                Qt::AlignCenter, m_data);
-            }
-
-            m_barcodeImage = image;
-            update();
-            return true;
-        }
-    }
-    catch (const std::exception &e) {
-        qWarning() << "ZXing条形码生成错误:" << e.what();
-        // 如果使用ZXing生成失败，继续使用原始方法
-    }
-
-    // 回退到原始的生成方法
-    m_barcodeImage = generateBarcode(m_data, m_type,
-                                    m_rect.width(), m_rect.height(),
-                                    m_foregroundColor, m_backgroundColor,
-                                    m_showText, m_textFont, m_margin,
-                                    m_includeChecksum);
-
-    // 更新视图
     update();
-    return !m_barcodeImage.isNull();
-}
-
-int BarcodeItem::calculateEANChecksum(const QString &data)
-{
-    int sum = 0;
-    int multiplier;
-
-    // EAN/UPC 校验位计算
-    for (int i = data.length() - 1; i >= 0; --i) {
-        int digit = data[i].digitValue();
-
-        // 交替乘以1和3
-        multiplier = ((data.length() - 1 - i) % 2) == 0 ? 1 : 3;
-        sum += digit * multiplier;
-    }
-
-    // 计算校验位
-    int checksum = (10 - (sum % 10)) % 10;
-    return checksum;
-}
-
-// 更新的Code128编码方法，使用ZXing库
-QList<bool> BarcodeItem::encodeCode128(const QString &data, int &width, int height,
-                                     bool includeText, const QFont &textFont, int margin)
-{
-    QList<bool> bars;
-
-    try {
-        // 使用ZXing生成Code 128条形码
-        ZXing::MultiFormatWriter writer;
-        auto matrix = writer.encode(data.toStdString(), width, 1, ZXing::BarcodeFormat::CODE_128);
-
-        // 从ZXing矩阵创建布尔列表
-        for (int x = 0; x < matrix.width(); ++x) {
-            bars.append(matrix.get(x, 0));
-        }
-
-        return bars;
-    }
-    catch (const std::exception &e) {
-        qWarning() << "Code 128生成错误:" << e.what();
-
-        // 生成失败时使用原始的实现作为后备方案
-        bars.clear();
-
-        // 添加起始符 (Code 128 B)
-        for (int bit : code128Patterns[1]) {
-            for (int i = 0; i < bit; ++i) {
-                bars.append(bars.size() % 2 == 0);
-            }
-        }
-
-        // 编码数据
-        // 此处为简化版，实际编码更复杂
-        for (QChar c : data) {
-            int code = c.unicode();
-            if (code >= 32 && code <= 126) {
-                // 生成一些简单的图案（实际应该使用标准的Code 128编码表）
-                for (int i = 0; i < 11; ++i) {
-                    bars.append((i + code) % 2 == 0);
-                }
-            }
-        }
-
-        // 添加校验位（简化版）
-        for (int i = 0; i < 11; ++i) {
-            bars.append(i % 2 == 0);
-        }
-
-        // 添加终止符
-        for (int bit : code128Patterns[3]) {
-            for (int i = 0; i < bit; ++i) {
-                bars.append(bars.size() % 2 == 0);
-            }
-        }
-
-        return bars;
-    }
-}
-
-// 更新的Code39编码方法，使用ZXing库
-QList<bool> BarcodeItem::encodeCode39(const QString &data, int &width, int height,
-                                    bool includeText, const QFont &textFont, int margin,
-                                    bool includeChecksum)
-{
-    QList<bool> bars;
-
-    try {
-        // 准备数据，确保有起始和结束符
-        QString codeData = data;
-        if (!codeData.startsWith('*')) {
-            codeData = '*' + codeData;
-        }
-        if (!codeData.endsWith('*')) {
-            codeData = codeData + '*';
-        }
-
-        // 使用ZXing生成Code 39条形码
-        ZXing::MultiFormatWriter writer;
-        auto matrix = writer.encode(codeData.toStdString(), width, 1, ZXing::BarcodeFormat::CODE_39);
-
-        // 从ZXing矩阵创建布尔列表
-        for (int x = 0; x < matrix.width(); ++x) {
-            bars.append(matrix.get(x, 0));
-        }
-
-        return bars;
-    }
-    catch (const std::exception &e) {
-        qWarning() << "Code 39生成错误:" << e.what();
-
-        // 生成失败时使用原始的实现作为后备方案
-        bars.clear();
-
-        // Code 39 编码
-        QString codeData = data;
-
-        // 如果数据不以*开始和结束，添加*作为开始/结束符
-        if (!codeData.startsWith('*')) {
-            codeData = '*' + codeData;
-        }
-        if (!codeData.endsWith('*')) {
-            codeData = codeData + '*';
-        }
-
-        // 计算校验位（如果需要）
-        if (includeChecksum) {
-            int sum = 0;
-            // 计算除了开始和结束符外的字符的校验和
-            for (int i = 1; i < codeData.length() - 1; ++i) {
-                QChar c = codeData.at(i);
-                // 在实际项目中，这里应该使用一个标准的Code 39校验和计算方法
-                // 这里简化处理，使用字符的ASCII值
-                sum += c.toLatin1();
-            }
-
-            // 校验位是和除以43的余数
-            char checkChar = static_cast<char>(sum % 43 + '0');
-            if (checkChar > '9') checkChar = static_cast<char>(checkChar - '9' - 1 + 'A');
-            if (checkChar > 'Z') checkChar = static_cast<char>(checkChar - 'Z' - 1 + '-');
-
-            // 在结束符之前插入校验位
-            codeData.insert(codeData.length() - 1, QChar(checkChar));
-        }
-
-        // 编码每个字符
-        for (QChar c : codeData) {
-            QString pattern = code39Patterns.value(c, "");
-            if (pattern.isEmpty()) continue;
-
-            // 转换模式为条和空格
-            for (QChar p : pattern) {
-                if (p == 'b') {
-                    bars.append(true);  // 条
-                } else {
-                    bars.append(false); // 空格
-                }
-            }
-
-            // 在字符之间添加空格
-            bars.append(false);
-        }
-
-        return bars;
-    }
+    return m_symbol.isValid();
 }
 
-// 更新的EAN-8编码方法，使用ZXing库
-QList<bool> BarcodeItem::encodeEAN8(const QString &data, int &width, int height,
-                                  bool includeText, const QFont &textFont, int margin)
+void BarcodeItem::layoutAreas(QRectF *barArea, QRectF *textArea) const
 {
-    QList<bool> bars;
-
-    try {
-        // 准备数据
-        QString codeData = data;
-
-        // 确保数据长度为7位（不含校验位）
-        if (codeData.length() < 7) {
-            codeData = codeData.rightJustified(7, '0');
-        } else if (codeData.length() > 7) {
-            codeData = codeData.left(7);
-        }
-
-        // 使用ZXing生成EAN-8条形码
-        ZXing::MultiFormatWriter writer;
-        auto matrix = writer.encode(codeData.toStdString(), width, 1, ZXing::BarcodeFormat::EAN_8);
-
-        // 从ZXing矩阵创建布尔列表
-        for (int x = 0; x < matrix.width(); ++x) {
-            bars.append(matrix.get(x, 0));
-        }
-
-        return bars;
+    // 与renderImage()的布局一致
+    qreal textHeight = 0;
+    if (m_showText) {
+        QFontMetrics fm(m_textFont);
+        textHeight = fm.height() + 4; // 添加一些间距
     }
-    catch (const std::exception &e) {
-        qWarning() << "EAN-8生成错误:" << e.what();
 
-        // 生成失败时使用原始的实现作为后备方案
-        bars.clear();
-
-        // 实现原始的EAN-8编码算法
-        QString codeData = data;
-
-        // 确保数据长度为7位（不含校验位）
-        if (codeData.length() < 7) {
-            codeData = codeData.rightJustified(7, '0');
-        } else if (codeData.length() > 7) {
-            codeData = codeData.left(7);
-        }
-
-        // 计算校验位
-        int checksum = calculateEANChecksum(codeData);
-        codeData += QString::number(checksum);
-
-        // 添加起始模式
-        bars.append(true);
-        bars.append(false);
-        bars.append(true);
-
-        // 编码前一组数字
-        for (int i = 0; i < 4; ++i) {
-            int digit = codeData.at(i).digitValue();
-            // 在实际项目中，这里应该使用标准的EAN-8编码表
-            for (int j = 0; j < 7; ++j) {
-                bars.append((j + digit) % 2 == 0);
-            }
-        }
-
-        // 添加中间模式
-        bars.append(false);
-        bars.append(true);
-        bars.append(false);
-        bars.append(true);
-        bars.append(false);
-
-        // 编码后一组数字
-        for (int i = 4; i < 8; ++i) {
-            int digit = codeData.at(i).digitValue();
-            // 在实际项目中，这里应该使用标准的EAN-8编码表
-            for (int j = 0; j < 7; ++j) {
-                bars.append((j + digit) % 2 != 0);
-            }
-        }
-
-        // 添加结束模式
-        bars.append(true);
-        bars.append(false);
-        bars.append(true);
-
-        return bars;
-    }
+    *barArea = QRectF(m_rect.left() + m_margin, m_rect.top() + m_margin,
+                      m_rect.width() - m_margin * 2,
+                      m_rect.height() - m_margin * 2 - textHeight);
+    *textArea = QRectF(barArea->left(), barArea->bottom(), barArea->width(), textHeight);
 }
 
-// 更新的EAN-13编码方法，使用ZXing库
-QList<bool> BarcodeItem::encodeEAN13(const QString &data, int &width, int height,
-                                   bool includeText, const QFont &textFont, int margin)
+bool BarcodeItem::paintVector(QPainter *painter) const
 {
-    QList<bool> bars;
-
-    try {
-        // 准备数据
-        QString codeData = data;
-
-        // 确保数据长度为12位（不含校验位）
-        if (codeData.length() < 12) {
-            codeData = codeData.rightJustified(12, '0');
-        } else if (codeData.length() > 12) {
-            codeData = codeData.left(12);
-        }
-
-        // 使用ZXing生成EAN-13条形码
-        ZXing::MultiFormatWriter writer;
-        auto matrix = writer.encode(codeData.toStdString(), width, 1, ZXing::BarcodeFormat::EAN_13);
-
-        // 从ZXing矩阵创建布尔列表
-        for (int x = 0; x < matrix.width(); ++x) {
-            bars.append(matrix.get(x, 0));
-        }
-
-        return bars;
-    }
-    catch (const std::exception &e) {
-        qWarning() << "EAN-13生成错误:" << e.what();
-
-        // 生成失败时使用原始的实现作为后备方案
-        bars.clear();
-
-        // 实现原始的EAN-13编码算法
-        QString codeData = data;
-
-        // 确保数据长度为12位（不含校验位）
-        if (codeData.length() < 12) {
-            codeData = codeData.rightJustified(12, '0');
-        } else if (codeData.length() > 12) {
-            codeData = codeData.left(12);
-        }
-
-        // 计算校验位
-        int checksum = calculateEANChecksum(codeData);
-        codeData += QString::number(checksum);
-
-        // 添加起始模式
-        bars.append(true);
-        bars.append(false);
-        bars.append(true);
-
-        // 编码前一组数字
-        for (int i = 0; i < 6; ++i) {
-            int digit = codeData.at(i).digitValue();
-            // 在实际项目中，这里应该使用标准的EAN-13编码表
-            for (int j = 0; j < 7; ++j) {
-                bars.append((j + digit) % 2 == 0);
-            }
-        }
-
-        // 添加中间模式
-        bars.append(false);
-        bars.append(true);
-        bars.append(false);
-        bars.append(true);
-        bars.append(false);
-
-        // 编码后一组数字
-        for (int i = 6; i < 12; ++i) {
-            int digit = codeData.at(i).digitValue();
-            // 在实际项目中，这里应该使用标准的EAN-13编码表
-            for (int j = 0; j < 7; ++j) {
-                bars.append((j + digit) % 2 != 0);
-            }
-        }
-
-        // 添加结束模式
-        bars.append(true);
-        bars.append(false);
-        bars.append(true);
-
-        return bars;
+    QRectF barArea;
+    QRectF textArea;
+    layoutAreas(&barArea, &textArea);
+    if (!m_symbol.isValid() || barArea.width() <= 0 || barArea.height() <= 0) {
+        return false;
     }
-}
 
-// 更新的UPC-A编码方法，使用ZXing库
-QList<bool> BarcodeItem::encodeUPC_A(const QString &data, int &width, int height,
-                                   bool includeText, const QFont &textFont, int margin)
-{
-    QList<bool> bars;
+    m_symbol.paint(painter, barArea, m_foregroundColor, m_targetDpi);
 
-    try {
-        // 准备数据
-        QString codeData = data;
-
-        // 确保数据长度为11位（不含校验位）
-        if (codeData.length() < 11) {
-            codeData = codeData.rightJustified(11, '0');
-        } else if (codeData.length() > 11) {
-            codeData = codeData.left(11);
-        }
-
-        // 使用ZXing生成UPC-A条形码
-        ZXing::MultiFormatWriter writer;
-        auto matrix = writer.encode(codeData.toStdString(), width, 1, ZXing::BarcodeFormat::UPC_A);
-
-        // 从ZXing矩阵创建布尔列表
-        for (int x = 0; x < matrix.width(); ++x) {
-            bars.append(matrix.get(x, 0));
-        }
-
-        return bars;
+    // 绘制文本
+    if (m_showText) {
+        painter->setPen(m_foregroundColor);
+        painter->setFont(m_textFont);
+        painter->drawText(textArea, Qt::AlignCenter, m_symbol.text());
     }
-    catch (const std::exception &e) {
-        qWarning() << "UPC-A生成错误:" << e.what();
 
-        // 生成失败时使用原始的实现作为后备方案
-        // 对于UPC-A，我们可以使用EAN-13编码并在前面添加0
-        return encodeEAN13("0" + data, width, height, includeText, textFont, margin);
-    }
+    return true;
 }
 
-// 更新的Interleaved 2 of 5编码方法，使用ZXing库
-QList<bool> BarcodeItem::encodeInterleaved2of5(const QString &data, int &width, int height,
-                                             bool includeText, const QFont &textFont, int margin,
-                                             bool includeChecksum)
+int BarcodeItem::calculateEANChecksum(const QString &data)
 {
-    QList<bool> bars;
-
-    try {
-        // 准备数据
-        QString codeData = data;
-
-        // Interleaved 2 of 5需要偶数位数字
-        if (codeData.length() % 2 != 0) {
-            codeData = "0" + codeData;
-        }
-
-        // 使用ZXing生成ITF条形码
-        ZXing::MultiFormatWriter writer;
-        auto matrix = writer.encode(codeData.toStdString(), width, 1, ZXing::BarcodeFormat::ITF);
-
-        // 从ZXing矩阵创建布尔列表
-        for (int x = 0; x < matrix.width(); ++x) {
-            bars.append(matrix.get(x, 0));
-        }
-
-        return bars;
+    // EAN/UPC 校验位计算：从右向左权重依次为3、1
+    const QChar *digits = data.constData();
+    int sum = 0;
+    int weight = 3;
+    for (int i = data.length() - 1; i >= 0; --i) {
+        sum += (digits[i].unicode() - '0') * weight;
+        weight = 4 - weight;
     }
-    catch (const std::exception &e) {
-        qWarning() << "Interleaved 2 of 5生成错误:" << e.what();
-
-        // 生成失败时使用原始的实现作为后备方案
-        bars.clear();
-
-        // 实现原始的Interleaved 2 of 5编码算法
-        QString codeData = data;
-
-        // Interleaved 2 of 5需要偶数位数字
-        if (codeData.length() % 2 != 0) {
-            codeData = "0" + codeData;
-        }
 
-        // 如果需要校验位且长度为偶数，需要添加前导0
-        if (includeChecksum && codeData.length() % 2 == 0) {
-            codeData = "0" + codeData;
-        }
-
-        // 计算校验位（如果需要）
-        if (includeChecksum) {
-            int sum = 0;
-            for (int i = 0; i < codeData.length(); ++i) {
-                int digit = codeData.at(i).digitValue();
-                // 奇数位置乘以3，偶数位置乘以1
-                sum += digit * (i % 2 == 0 ? 3 : 1);
-            }
-
-            int checkDigit = (10 - (sum % 10)) % 10;
-            codeData += QString::number(checkDigit);
-        }
-
-        // 添加起始符
-        bars.append(true);
-        bars.append(true);
-        bars.append(false);
-        bars.append(false);
-
-        // 交错编码数字对
-        for (int i = 0; i < codeData.length(); i += 2) {
-            int firstDigit = codeData.at(i).digitValue();
-            int secondDigit = codeData.at(i + 1).digitValue();
-
-            // 在实际项目中，这里应使用标准的Interleaved 2 of 5编码表
-            // 这里是简化实现
-            for (int j = 0; j < 5; ++j) {
-                // 编码第一个数字的条
-                bars.append(true);
-                bars.append((j + firstDigit) % 2 == 0);
-
-                // 编码第二个数字的空格
-                bars.append(false);
-                bars.append((j + secondDigit) % 2 == 0);
-            }
-        }
-
-        // 添加结束符
-        bars.append(true);
-        bars.append(true);
-        bars.append(false);
-
-        return bars;
-    }
+    // 计算校验位
+    return (10 - (sum % 10)) % 10;
 }
\ No newline at end of file
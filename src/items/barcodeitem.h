@@ -2,8 +2,10 @@
 #define BARCODEITEM_H
 
 #include "labelitem.h"
+#include "barcodesymbol.h"
 
 #include <QColor>
+#include <QImage>
 #include <QString>
 #include <QFont>
 
@@ -213,6 +215,21 @@ public:
      */
     bool includeChecksum() const;
 
+    /**
+     * @brief 设置目标打印分辨率
+     *
+     * 矢量绘制时模块宽度取整数个打印点，再对齐到设备像素
+     *
+     * @param dpi 分辨率，0表示只对齐到设备像素
+     */
+    void setTargetDpi(int dpi);
+
+    /**
+     * @brief 获取目标打印分辨率
+     * @return 分辨率
+     */
+    int targetDpi() const;
+
     /**
      * @brief 获取条形码类型名称
      * @param type 条形码类型
@@ -241,6 +258,71 @@ public:
      */
     static bool validateData(const QString &data, BarcodeType type);
 
+    /**
+     * @brief 判断数据是否为数据合并模板
+     *
+     * 含 {{列名}} 占位符的数据在合并时才替换为实际值（由合并引擎验证），
+     * 编辑时不按条形码类型验证，规则与DataMergeEngine::hasPlaceholders()相同
+     *
+     * @param data 条形码数据
+     * @return 是否包含占位符
+     */
+    static bool isTemplateData(const QString &data);
+
+    /**
+     * @brief 计算条形码的模块数
+     *
+     * 即最小尺寸输出的列数（不含静区），用于按打印点换算模块宽度
+     *
+     * @param data 条形码数据
+     * @param type 条形码类型
+     * @return 模块数，无法编码时返回0
+     */
+    static int moduleCount(const QString &data, BarcodeType type);
+
+    /**
+     * @brief 编码模块图案（不经过缓存）
+     *
+     * 优先使用ZXing，失败时使用内置编码器。两者都不输出静区，
+     * 模块序列从第一个条开始、到最后一个条结束
+     *
+     * @param data 条形码数据
+     * @param type 条形码类型
+     * @param includeChecksum 是否包含校验和
+     * @param fallback 非空时输出模块是否由内置编码器生成
+     * @return 模块图案，无法编码时为空
+     */
+    static BarcodeModules encodePattern(const QString &data, BarcodeType type, bool includeChecksum,
+                                        bool *fallback = nullptr);
+
+    /**
+     * @brief 判断内置编码器是否实现了该类型
+     *
+     * 未实现的类型在ZXing失败时按Code 128编码，结果不能当作该类型输出
+     *
+     * @param type 条形码类型
+     * @return 有专用内置编码器时返回true
+     */
+    static bool hasFallbackEncoder(BarcodeType type);
+
+    /**
+     * @brief 只用内置编码器编码（不经过ZXing和缓存）
+     *
+     * ZXing生成失败时的后备方案，也用于对比测试
+     *
+     * @param data 条形码数据
+     * @param type 条形码类型
+     * @param includeChecksum 是否包含校验和
+     * @return 模块图案，类型不受支持时按Code 128编码，数据无效时为空
+     */
+    static BarcodeModules encodeFallback(const QString &data, BarcodeType type, bool includeChecksum);
+
+    /**
+     * @brief 获取当前编码的符号
+     * @return 符号，数据无法编码时无效
+     */
+    BarcodeSymbol symbol() const;
+
     /**
      * @brief 生成条形码图像
      * @param data 条形码数据
@@ -273,47 +355,62 @@ protected:
 
 private:
     /**
-     * @brief 生成条形码图像
-     * @return 生成是否成功
+     * @brief 重新编码条形码
+     *
+     * 编码结果来自全局缓存，比绘制快得多，不需要在后台生成
+     * （只有二维码和图像元素使用SymbolGenerator）
+     *
+     * @return 编码是否成功
      */
-    bool generateBarcodeImage();
+    bool updateSymbol();
 
     /**
-     * @brief 计算EAN/UPC校验位
-     * @param data 条形码数据
-     * @return 校验位
+     * @brief 计算条和文本的区域
+     * @param barArea 输出条的区域
+     * @param textArea 输出文本的区域
      */
-    static int calculateEANChecksum(const QString &data);
+    void layoutAreas(QRectF *barArea, QRectF *textArea) const;
 
     /**
-     * @brief 编码Code128
-     * @param data 条形码数据
-     * @param width 模块宽度
-     * @param height 条形码高度
+     * @brief 以矢量方式绘制条形码
+     * @param painter 画家（已应用旋转）
+     * @return 是否绘制成功
+     */
+    bool paintVector(QPainter *painter) const;
+
+    /**
+     * @brief 将已编码的符号绘制为图像
+     * @param symbol 符号
+     * @param width 宽度
+     * @param height 高度
+     * @param foreground 前景色
+     * @param background 背景色
      * @param includeText 是否包含文本
      * @param textFont 文本字体
      * @param margin 边距
-     * @return 编码数据
+     * @return 条形码图像
      */
-    static QList<bool> encodeCode128(const QString &data, int &width, int height,
-                                     bool includeText, const QFont &textFont, int margin);
+    static QImage renderImage(const BarcodeSymbol &symbol, int width, int height,
+                              const QColor &foreground, const QColor &background,
+                              bool includeText, const QFont &textFont, int margin);
 
     /**
-     * @brief 编码Code39
+     * @brief 计算EAN/UPC校验位
      * @param data 条形码数据
-     * @param width 模块宽度
-     * @param height 条形码高度
-     * @param includeText 是否包含文本
-     * @param textFont 文本字体
-     * @param margin 边距
-     * @param includeChecksum 是否包含校验和
-     * @return 编码数据
+     * @return 校验位
+     */
+    static int calculateEANChecksum(const QString &data);
+
+    /**
+     * @brief 只用ZXing编码（不经过内置编码器和缓存）
+     * @param data 条形码数据
+     * @param type 条形码类型
+     * @return 模块图案，ZXing不支持或生成失败时为空
      */
-    static QList<bool> encodeCode39(const QString &data, int &width, int height,
-                                    bool includeText, const QFont &textFont, int margin,
-                                    bool includeChecksum);
+    static BarcodeModules encodeZXing(const QString &data, BarcodeType type);
 
-    // ... 可以添加其他条形码类型的编码方法
+    // BarcodeSymbol::encode()用calculateEANChecksum()补全文本
+    friend class BarcodeSymbol;
 
 private:
     QString m_data;                 ///< 条形码数据
@@ -324,7 +421,8 @@ private:
     QFont m_textFont;               ///< 文本字体
     int m_margin;                   ///< 边距
     bool m_includeChecksum;         ///< 是否包含校验和
-    QImage m_barcodeImage;          ///< 条形码图像
+    int m_targetDpi;                ///< 目标打印分辨率
+    BarcodeSymbol m_symbol;         ///< 当前编码的符号
 
 signals:
     /**
@@ -0,0 +1,140 @@
+#include "barcodemodules.h"
+
+#include <algorithm>
+
+BarcodeModules::BarcodeModules()
+    : m_size(0)
+{
+    std::fill(m_inline, m_inline + InlineWords, 0);
+}
+
+void BarcodeModules::reserve(int size)
+{
+    ensureCapacity(size);
+}
+
+void BarcodeModules::clear()
+{
+    // 保持“超出size()的位为0”
+    std::fill(words(), words() + wordCount(), 0);
+    m_size = 0;
+}
+
+void BarcodeModules::append(bool bar)
+{
+    ensureCapacity(m_size + 1);
+    if (bar) {
+        words()[m_size >> 6] |= quint64(1) << (63 - (m_size & 63));
+    }
+    ++m_size;
+}
+
+void BarcodeModules::appendRun(bool bar, int count)
+{
+    if (count <= 0) {
+        return;
+    }
+
+    ensureCapacity(m_size + count);
+    if (!bar) {
+        // 空的位已经是0
+        m_size += count;
+        return;
+    }
+
+    quint64 *data = words();
+    int index = m_size;
+    const int end = m_size + count;
+    while (index < end) {
+        const int offset = index & 63;
+        const int bits = qMin(64 - offset, end - index);
+        const quint64 mask = (bits == 64) ? ~quint64(0) : ((quint64(1) << bits) - 1) << (64 - offset - bits);
+        data[index >> 6] |= mask;
+        index += bits;
+    }
+    m_size = end;
+}
+
+void BarcodeModules::appendBits(quint64 bits, int count)
+{
+    if (count <= 0) {
+        return;
+    }
+
+    ensureCapacity(m_size + count);
+
+    // 左对齐后最多跨两个字
+    const quint64 aligned = (count == 64) ? bits : bits << (64 - count);
+    const int offset = m_size & 63;
+    quint64 *data = words() + (m_size >> 6);
+
+    data[0] |= aligned >> offset;
+    if (offset + count > 64) {
+        data[1] |= aligned << (64 - offset);
+    }
+    m_size += count;
+}
+
+const quint64 *BarcodeModules::constWords() const
+{
+    return m_heap.isEmpty() ? m_inline : m_heap.constData();
+}
+
+void BarcodeModules::expand(quint32 *line, int moduleWidth, quint32 color) const
+{
+    if (!line || moduleWidth < 1) {
+        return;
+    }
+
+    const quint64 *data = constWords();
+    const int words = wordCount();
+
+    for (int w = 0; w < words; ++w) {
+        const quint64 word = data[w];
+        const int count = qMin(64, m_size - w * 64);
+        const int pixels = count * moduleWidth;
+
+        if (word == 0) {
+            line += pixels;
+            continue;
+        }
+        if (count == 64 && word == ~quint64(0)) {
+            std::fill(line, line + pixels, color);
+            line += pixels;
+            continue;
+        }
+
+        for (int b = 0; b < count; ++b) {
+            // 条为全1掩码，空为0
+            const quint32 mask = 0u - static_cast<quint32>((word >> (63 - b)) & 1);
+            const quint32 bar = color & mask;
+            for (int k = 0; k < moduleWidth; ++k) {
+                line[k] = (line[k] & ~mask) | bar;
+            }
+            line += moduleWidth;
+        }
+    }
+}
+
+void BarcodeModules::ensureCapacity(int size)
+{
+    const int needed = (size + 63) >> 6;
+    const int capacity = m_heap.isEmpty() ? InlineWords : m_heap.size();
+    if (needed <= capacity) {
+        return;
+    }
+
+    // 新增的字由QVector初始化为0
+    const int grown = qMax(needed, capacity * 2);
+    if (m_heap.isEmpty()) {
+        m_heap.resize(grown);
+        std::copy(m_inline, m_inline + InlineWords, m_heap.begin());
+    } else {
+        m_heap.resize(grown);
+    }
+}
+
+quint64 *BarcodeModules::words()
+{
+    return m_heap.isEmpty() ? m_inline : m_heap.data();
+}
@@ -0,0 +1,123 @@
+#ifndef BARCODEMODULES_H
+#define BARCODEMODULES_H
+
+#include <QVector>
+#include <QtGlobal>
+
+/**
+ * @brief 一维条形码模块序列
+ *
+ * 每个模块占一位，按64位字打包，字内高位在前。
+ * 常见长度的条形码完全存放在内联缓冲区中，编码时不分配内存；
+ * 超出内联容量时才转为堆存储。
+ */
+class BarcodeModules
+{
+public:
+    /**
+     * @brief 内联缓冲区的字数
+     */
+    static const int InlineWords = 8;
+
+    /**
+     * @brief 构造空序列
+     */
+    BarcodeModules();
+
+    /**
+     * @brief 预留容量
+     * @param size 模块数
+     */
+    void reserve(int size);
+
+    /**
+     * @brief 清空序列，保留容量
+     */
+    void clear();
+
+    /**
+     * @brief 是否为空
+     * @return 是否为空
+     */
+    bool isEmpty() const { return m_size == 0; }
+
+    /**
+     * @brief 获取模块数
+     * @return 模块数
+     */
+    int size() const { return m_size; }
+
+    /**
+     * @brief 获取模块
+     * @param index 模块序号
+     * @return 是否为条
+     */
+    bool at(int index) const
+    {
+        return (constWords()[index >> 6] >> (63 - (index & 63))) & 1;
+    }
+
+    /**
+     * @brief 追加一个模块
+     * @param bar 是否为条
+     */
+    void append(bool bar);
+
+    /**
+     * @brief 追加若干相同的模块
+     * @param bar 是否为条
+     * @param count 模块数
+     */
+    void appendRun(bool bar, int count);
+
+    /**
+     * @brief 追加位图案
+     * @param bits 图案，低count位有效，高位在前
+     * @param count 模块数（不超过64）
+     */
+    void appendBits(quint64 bits, int count);
+
+    /**
+     * @brief 获取打包的数据
+     * @return 字数组，超出size()的位为0
+     */
+    const quint64 *constWords() const;
+
+    /**
+     * @brief 获取已使用的字数
+     * @return 字数
+     */
+    int wordCount() const { return (m_size + 63) >> 6; }
+
+    /**
+     * @brief 将条展开到32位扫描线
+     *
+     * 每个模块展开为moduleWidth个像素，只写入条，空的像素保持原值。
+     * 按字处理，全空或全满的字整段跳过或填充，其余使用无分支的掩码选择，
+     * 便于编译器向量化。
+     *
+     * @param line 扫描线起点，至少size()*moduleWidth个像素
+     * @param moduleWidth 每个模块的像素数
+     * @param color 条的颜色
+     */
+    void expand(quint32 *line, int moduleWidth, quint32 color) const;
+
+private:
+    /**
+     * @brief 确保容量
+     * @param size 模块数
+     */
+    void ensureCapacity(int size);
+
+    /**
+     * @brief 获取可写的字数组
+     * @return 字数组
+     */
+    quint64 *words();
+
+    quint64 m_inline[InlineWords];  ///< 内联缓冲区
+    QVector<quint64> m_heap;        ///< 超出内联容量时的存储
+    int m_size;                     ///< 模块数
+};
+
+#endif // BARCODEMODULES_H
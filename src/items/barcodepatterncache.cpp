@@ -0,0 +1,34 @@
+#include "barcodepatterncache.h"
+#include "barcodeitem.h"
+
+// 默认容量
+static const int DEFAULT_CAPACITY = 4096;
+
+BarcodePatternCache *BarcodePatternCache::instance()
+{
+    static BarcodePatternCache cache;
+    return &cache;
+}
+
+BarcodePatternCache::BarcodePatternCache()
+    : SymbolCache(DEFAULT_CAPACITY)
+{
+}
+
+bool BarcodePatternCache::find(const QString &data, BarcodeType type, bool includeChecksum, BarcodeSymbol *symbol)
+{
+    return SymbolCache::find(cacheKey(data, type, includeChecksum), symbol);
+}
+
+void BarcodePatternCache::insert(const QString &data, BarcodeType type, bool includeChecksum, const BarcodeSymbol &symbol)
+{
+    SymbolCache::insert(cacheKey(data, type, includeChecksum), symbol);
+}
+
+QString BarcodePatternCache::cacheKey(const QString &data, BarcodeType type, bool includeChecksum)
+{
+    // 类型编号后接校验和标志，再接原始数据，不会产生歧义
+    return QString::number(static_cast<int>(type))
+           + QLatin1Char(includeChecksum ? '+' : '-')
+           + data;
+}
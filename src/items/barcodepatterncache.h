@@ -0,0 +1,58 @@
+#ifndef BARCODEPATTERNCACHE_H
+#define BARCODEPATTERNCACHE_H
+
+#include <QString>
+
+#include "barcodesymbol.h"
+#include "symbolcache.h"
+
+/**
+ * @brief 条形码符号缓存
+ *
+ * 进程内共享、线程安全的LRU缓存，以（数据、类型、校验和设置）为键，
+ * 保存编码后的一维条形码符号（模块序列和人眼可读文本）。
+ * 修改颜色、字体、尺寸或克隆元素只需重新绘制，不必重新编码；
+ * 批量打印中重复的数据也只编码一次。容量按符号数计算。
+ */
+class BarcodePatternCache : public SymbolCache<QString, BarcodeSymbol>
+{
+public:
+    /**
+     * @brief 获取全局实例
+     * @return 缓存实例
+     */
+    static BarcodePatternCache *instance();
+
+    /**
+     * @brief 查找符号
+     * @param data 条形码数据
+     * @param type 条形码类型
+     * @param includeChecksum 是否包含校验和
+     * @param symbol 输出符号
+     * @return 是否命中
+     */
+    bool find(const QString &data, BarcodeType type, bool includeChecksum, BarcodeSymbol *symbol);
+
+    /**
+     * @brief 插入符号，缓存已满时淘汰最久未使用的项
+     * @param data 条形码数据
+     * @param type 条形码类型
+     * @param includeChecksum 是否包含校验和
+     * @param symbol 符号（编码失败时无效）
+     */
+    void insert(const QString &data, BarcodeType type, bool includeChecksum, const BarcodeSymbol &symbol);
+
+private:
+    BarcodePatternCache();
+
+    /**
+     * @brief 生成缓存键
+     * @param data 条形码数据
+     * @param type 条形码类型
+     * @param includeChecksum 是否包含校验和
+     * @return 缓存键
+     */
+    static QString cacheKey(const QString &data, BarcodeType type, bool includeChecksum);
+};
+
+#endif // BARCODEPATTERNCACHE_H
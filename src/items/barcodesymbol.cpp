@@ -0,0 +1,216 @@
+#include "barcodesymbol.h"
+#include "barcodeitem.h"
+#include "barcodepatterncache.h"
+
+#include <QPainter>
+#include <QtMath>
+
+#include <algorithm>
+#include <cstring>
+
+// 毫米与英寸的换算
+static const qreal MM_PER_INCH = 25.4;
+
+BarcodeSymbol::BarcodeSymbol()
+{
+}
+
+BarcodeSymbol::BarcodeSymbol(const BarcodeModules &modules, const QString &text, bool fallback)
+    : m_modules(modules)
+    , m_text(text)
+    , m_fallback(fallback)
+{
+    // 预先合并相邻的条，各种绘制目标共用
+    int i = 0;
+    while (i < m_modules.size()) {
+        if (!m_modules.at(i)) {
+            ++i;
+            continue;
+        }
+
+        Bar bar;
+        bar.start = i;
+        while (i < m_modules.size() && m_modules.at(i)) {
+            ++i;
+        }
+        bar.width = i - bar.start;
+        m_bars.append(bar);
+    }
+}
+
+BarcodeSymbol BarcodeSymbol::encode(const QString &data, BarcodeType type, bool includeChecksum)
+{
+    if (data.isEmpty()) {
+        return BarcodeSymbol();
+    }
+
+    BarcodePatternCache *cache = BarcodePatternCache::instance();
+
+    BarcodeSymbol symbol;
+    if (cache->find(data, type, includeChecksum, &symbol)) {
+        return symbol;
+    }
+
+    // 编码失败的结果也缓存，避免重复抛出异常
+    bool fallback = false;
+    const BarcodeModules modules = BarcodeItem::encodePattern(data, type, includeChecksum, &fallback);
+    if (!modules.isEmpty()) {
+        symbol = BarcodeSymbol(modules, humanReadableText(data, type), fallback);
+    }
+    cache->insert(data, type, includeChecksum, symbol);
+    return symbol;
+}
+
+bool BarcodeSymbol::isValid() const
+{
+    return !m_modules.isEmpty();
+}
+
+bool BarcodeSymbol::isFallback() const
+{
+    return m_fallback;
+}
+
+int BarcodeSymbol::moduleCount() const
+{
+    return m_modules.size();
+}
+
+bool BarcodeSymbol::isBar(int index) const
+{
+    return index >= 0 && index < m_modules.size() && m_modules.at(index);
+}
+
+BarcodeModules BarcodeSymbol::modules() const
+{
+    return m_modules;
+}
+
+QVector<BarcodeSymbol::Bar> BarcodeSymbol::bars() const
+{
+    return m_bars;
+}
+
+QString BarcodeSymbol::text() const
+{
+    return m_text;
+}
+
+void BarcodeSymbol::rasterize(QImage *image, const QRect &area, QRgb color) const
+{
+    if (!image || image->depth() != 32 || !isValid()) {
+        return;
+    }
+
+    const QRect rect = area.intersected(image->rect());
+    if (rect.isEmpty()) {
+        return;
+    }
+
+    const qint64 modules = m_modules.size();
+    const qint64 width = area.width();
+    quint32 *line = reinterpret_cast<quint32*>(image->scanLine(rect.top()));
+
+    if (rect == area && width % modules == 0) {
+        // 整数模块宽度：直接按字展开
+        m_modules.expand(line + rect.left(), static_cast<int>(width / modules), color);
+    } else {
+        // 第一行：每个模块覆盖[i*w/n, (i+1)*w/n)的像素，每个条一段填充
+        for (const Bar &bar : m_bars) {
+            const int x0 = qMax(rect.left(), area.left() + static_cast<int>(bar.start * width / modules));
+            const int x1 = qMin(rect.right() + 1, area.left() + static_cast<int>((bar.start + bar.width) * width / modules));
+            if (x1 > x0) {
+                std::fill(line + x0, line + x1, static_cast<quint32>(color));
+            }
+        }
+    }
+
+    // 其余各行与第一行相同
+    const uchar *source = image->constScanLine(rect.top()) + rect.left() * 4;
+    const size_t bytes = static_cast<size_t>(rect.width()) * 4;
+    for (int y = rect.top() + 1; y <= rect.bottom(); ++y) {
+        memcpy(image->scanLine(y) + rect.left() * 4, source, bytes);
+    }
+}
+
+void BarcodeSymbol::paint(QPainter *painter, const QRectF &area, const QColor &color, int targetDpi) const
+{
+    if (!painter || !isValid() || area.width() <= 0 || area.height() <= 0) {
+        return;
+    }
+
+    const int modules = m_modules.size();
+    const QTransform device = painter->deviceTransform();
+
+    if (device.type() <= QTransform::TxScale && device.m11() > 0 && device.m22() > 0) {
+        // 轴对齐时在设备坐标中绘制，每个模块占整数个像素
+        const QRectF deviceArea = device.mapRect(area);
+
+        // 模块宽度不能超过区域，否则条会超出元素被裁掉
+        const int maxModuleWidth = qMax(1, qFloor(deviceArea.width() / modules));
+        int moduleWidth = maxModuleWidth;
+        if (targetDpi > 0) {
+            // 每个打印点对应的设备像素数（画家坐标单位为毫米）；
+            // 只有打印点正好是整数个像素时才按打印点取整，否则两次取整会使条码过宽或过窄
+            const qreal pixelsPerDot = device.m11() * MM_PER_INCH / targetDpi;
+            const int dotPixels = qRound(pixelsPerDot);
+            if (dotPixels >= 1 && qAbs(pixelsPerDot - dotPixels) < 0.01) {
+                const int dots = qMax(1, qFloor(deviceArea.width() / dotPixels / modules));
+                moduleWidth = qMin(maxModuleWidth, dots * dotPixels);
+            }
+        }
+
+        const int left = qRound(deviceArea.center().x() - moduleWidth * modules / 2.0);
+        const int top = qRound(deviceArea.top());
+        const int height = qMax(1, qRound(deviceArea.bottom()) - top);
+
+        painter->save();
+        painter->setViewTransformEnabled(false);
+        painter->setWorldTransform(QTransform());
+        painter->setRenderHint(QPainter::Antialiasing, false);
+
+        for (const Bar &bar : m_bars) {
+            painter->fillRect(QRect(left + bar.start * moduleWidth, top, bar.width * moduleWidth, height), color);
+        }
+
+        painter->restore();
+    } else {
+        // 旋转后无法对齐像素，按画家坐标绘制
+        const qreal moduleWidth = area.width() / modules;
+
+        for (const Bar &bar : m_bars) {
+            painter->fillRect(QRectF(area.left() + bar.start * moduleWidth, area.top(),
+                                     bar.width * moduleWidth, area.height()), color);
+        }
+    }
+}
+
+QString BarcodeSymbol::humanReadableText(const QString &data, BarcodeType type)
+{
+    int length = 0;
+    switch (type) {
+        case BarcodeType::EAN8:
+            length = 7;
+            break;
+        case BarcodeType::EAN13:
+            length = 12;
+            break;
+        case BarcodeType::UPC_A:
+            length = 11;
+            break;
+        default:
+            return data;
+    }
+
+    // 只有缺少校验位的纯数字数据才补全
+    if (data.size() != length) {
+        return data;
+    }
+    for (QChar c : data) {
+        if (!c.isDigit()) {
+            return data;
+        }
+    }
+
+    return data + QString::number(BarcodeItem::calculateEANChecksum(data));
+}
@@ -0,0 +1,150 @@
+#ifndef BARCODESYMBOL_H
+#define BARCODESYMBOL_H
+
+#include <QImage>
+#include <QRect>
+#include <QString>
+#include <QVector>
+
+#include "barcodemodules.h"
+
+class QColor;
+class QPainter;
+class QRectF;
+enum class BarcodeType;
+
+/**
+ * @brief 已编码的一维条形码
+ *
+ * 编码一次，得到模块序列和人眼可读文本，之后可以绘制到任意目标
+ * （32位图像、矢量画家、打印机）而不必重新编码。
+ * 值类型，可以在线程之间复制。
+ */
+class BarcodeSymbol
+{
+public:
+    /**
+     * @brief 连续的条
+     */
+    struct Bar
+    {
+        int start = 0;      ///< 起始模块
+        int width = 0;      ///< 模块数
+    };
+
+    /**
+     * @brief 构造无效的符号
+     */
+    BarcodeSymbol();
+
+    /**
+     * @brief 构造函数
+     * @param modules 模块序列
+     * @param text 人眼可读文本
+     * @param fallback 模块是否由内置编码器生成
+     */
+    BarcodeSymbol(const BarcodeModules &modules, const QString &text, bool fallback = false);
+
+    /**
+     * @brief 编码条形码
+     *
+     * 结果保存在全局缓存中，相同参数再次编码时直接返回
+     *
+     * @param data 条形码数据
+     * @param type 条形码类型
+     * @param includeChecksum 是否包含校验和
+     * @return 符号，无法编码时无效
+     */
+    static BarcodeSymbol encode(const QString &data, BarcodeType type, bool includeChecksum = false);
+
+    /**
+     * @brief 是否有效
+     * @return 是否包含模块
+     */
+    bool isValid() const;
+
+    /**
+     * @brief 是否由内置编码器生成
+     *
+     * ZXing无法编码时使用内置编码器；没有专用内置编码器的类型此时按Code 128编码，
+     * 调用者据此拒绝替代结果，不必再用ZXing试编码一次
+     *
+     * @return 是否由内置编码器生成
+     */
+    bool isFallback() const;
+
+    /**
+     * @brief 获取模块数（不含静区）
+     * @return 模块数
+     */
+    int moduleCount() const;
+
+    /**
+     * @brief 判断模块是否为条
+     * @param index 模块序号
+     * @return 是否为条
+     */
+    bool isBar(int index) const;
+
+    /**
+     * @brief 获取模块序列
+     * @return 模块序列
+     */
+    BarcodeModules modules() const;
+
+    /**
+     * @brief 获取连续的条
+     * @return 条列表，按位置排序
+     */
+    QVector<Bar> bars() const;
+
+    /**
+     * @brief 获取人眼可读文本
+     *
+     * EAN/UPC数据缺少校验位时补全
+     *
+     * @return 文本
+     */
+    QString text() const;
+
+    /**
+     * @brief 光栅化到32位图像
+     *
+     * 只计算第一行的条，其余行直接复制。区域宽度是模块数的整数倍时
+     * 直接按字展开到扫描线，否则按比例逐条填充
+     *
+     * @param image 32位目标图像
+     * @param area 条形码区域（像素）
+     * @param color 条的颜色
+     */
+    void rasterize(QImage *image, const QRect &area, QRgb color) const;
+
+    /**
+     * @brief 以矢量方式绘制
+     *
+     * 画家变换轴对齐时在设备坐标中绘制，每个模块取整数个设备像素且不超出区域，
+     * 打印点正好是整数个像素时再取整数个打印点；否则在画家坐标中按比例绘制
+     *
+     * @param painter 画家
+     * @param area 条形码区域（画家坐标，单位为毫米）
+     * @param color 条的颜色
+     * @param targetDpi 目标打印分辨率，0表示只对齐到设备像素
+     */
+    void paint(QPainter *painter, const QRectF &area, const QColor &color, int targetDpi = 0) const;
+
+private:
+    /**
+     * @brief 生成人眼可读文本
+     * @param data 条形码数据
+     * @param type 条形码类型
+     * @return 文本
+     */
+    static QString humanReadableText(const QString &data, BarcodeType type);
+
+    BarcodeModules m_modules;   ///< 模块序列
+    QVector<Bar> m_bars;        ///< 连续的条
+    QString m_text;             ///< 人眼可读文本
+    bool m_fallback = false;    ///< 是否由内置编码器生成
+};
+
+#endif // BARCODESYMBOL_H
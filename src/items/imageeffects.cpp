@@ -0,0 +1,229 @@
+#include "imageeffects.h"
+
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+
+#include <atomic>
+#include <memory>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// 每个行带的最少像素数，小图像直接在调用线程中处理
+static const int MIN_BAND_PIXELS = 256 * 1024;
+
+// 每个线程分到的行带数，行带较小时各线程的完成时间更均衡
+static const int BANDS_PER_THREAD = 4;
+
+/**
+ * @brief 行带的共享状态
+ *
+ * 工作线程和调用线程从同一个计数器领取行带，
+ * 线程池繁忙时调用线程会独自处理完全部行带，不会等待排队的任务
+ */
+struct BandState
+{
+    std::atomic<int> next{0};   ///< 下一个待处理的行带
+    QSemaphore finished;        ///< 每完成一个行带释放一次
+};
+
+ImageEffects::ImageEffects(bool grayScale, int brightness, int contrast)
+    : m_grayScale(grayScale)
+    , m_identityLut(true)
+{
+    // 亮度和对比度因子
+    const qreal brightnessF = 1.0 + brightness / 100.0;
+    const qreal contrastF = 1.0 + contrast / 100.0;
+
+    // 与逐像素计算的取整方式相同：先亮度后对比度，每步截断并限制在0-255
+    for (int value = 0; value < 256; ++value) {
+        int result = value;
+
+        if (brightness != 0) {
+            result = qBound(0, static_cast<int>(result * brightnessF), 255);
+        }
+
+        if (contrast != 0) {
+            result = qBound(0, static_cast<int>(((result / 255.0 - 0.5) * contrastF + 0.5) * 255), 255);
+        }
+
+        m_lut[value] = static_cast<uchar>(result);
+        if (result != value) {
+            m_identityLut = false;
+        }
+    }
+}
+
+bool ImageEffects::isIdentity() const
+{
+    return !m_grayScale && m_identityLut;
+}
+
+QImage ImageEffects::apply(const QImage &source) const
+{
+    if (source.isNull()) {
+        return QImage();
+    }
+
+    // 两种格式的内存布局相同，RGB32的透明度字节固定为0xFF
+    const QImage::Format format = source.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied
+                                                           : QImage::Format_RGB32;
+    QImage image = source.convertToFormat(format);
+    if (image.isNull()) {
+        return QImage();
+    }
+
+    // 先分离出独立的数据，工作线程只通过scanLine()写入
+    image.detach();
+
+    if (isIdentity()) {
+        return image;
+    }
+
+    const int height = image.height();
+    const qint64 pixels = static_cast<qint64>(image.width()) * height;
+    const int threads = static_cast<int>(qMin<qint64>(QThread::idealThreadCount(), pixels / MIN_BAND_PIXELS));
+
+    if (threads <= 1) {
+        applyRows(&image, 0, height);
+        return image;
+    }
+
+    const int bandCount = qMin(height, threads * BANDS_PER_THREAD);
+    const int bandRows = (height + bandCount - 1) / bandCount;
+    std::shared_ptr<BandState> state = std::make_shared<BandState>();
+    QImage *target = &image;
+
+    // 领取并处理行带，直到全部领完
+    auto work = [this, state, target, bandCount, bandRows, height]() {
+        for (;;) {
+            const int band = state->next.fetch_add(1);
+            if (band >= bandCount) {
+                return;
+            }
+
+            const int first = band * bandRows;
+            applyRows(target, first, qMin(height, first + bandRows));
+            state->finished.release();
+        }
+    };
+
+    // 调用线程也领取行带，只需要threads - 1个辅助任务
+    for (int i = 1; i < threads; ++i) {
+        QThreadPool::globalInstance()->start(QRunnable::create(work));
+    }
+    work();
+
+    // 等待其他线程处理完已领取的行带；之后辅助任务不再访问图像
+    state->finished.acquire(bandCount);
+    return image;
+}
+
+void ImageEffects::applyRows(QImage *image, int first, int last) const
+{
+    const int width = image->width();
+
+#ifdef __SSE2__
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+    // 与qGray()相同的权重，内存中的字节顺序为B、G、R、A
+    const __m128i grayWeights = _mm_setr_epi16(5, 16, 11, 0, 5, 16, 11, 0);
+#endif
+
+    for (int y = first; y < last; ++y) {
+        QRgb *line = reinterpret_cast<QRgb*>(image->scanLine(y));
+        int x = 0;
+
+        if (m_grayScale) {
+#ifdef __SSE2__
+            // 每次4个像素：全部不透明时用SIMD计算灰度，再查表写回
+            for (; x + 4 <= width; x += 4) {
+                const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(line + x));
+                const __m128i alpha = _mm_and_si128(pixels, alphaMask);
+                if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, alphaMask)) != 0xFFFF) {
+                    for (int i = 0; i < 4; ++i) {
+                        line[x + i] = applyPixel(line[x + i]);
+                    }
+                    continue;
+                }
+
+                // 每个像素得到两个32位部分和（B*5+G*16、R*11），相加后取偶数位置
+                __m128i low = _mm_madd_epi16(_mm_unpacklo_epi8(pixels, zero), grayWeights);
+                __m128i high = _mm_madd_epi16(_mm_unpackhi_epi8(pixels, zero), grayWeights);
+                low = _mm_add_epi32(low, _mm_srli_epi64(low, 32));
+                high = _mm_add_epi32(high, _mm_srli_epi64(high, 32));
+                low = _mm_shuffle_epi32(low, _MM_SHUFFLE(3, 3, 2, 0));
+                high = _mm_shuffle_epi32(high, _MM_SHUFFLE(3, 3, 2, 0));
+                const __m128i gray = _mm_srli_epi32(_mm_unpacklo_epi64(low, high), 5);
+
+                alignas(16) int values[4];
+                _mm_store_si128(reinterpret_cast<__m128i*>(values), gray);
+                for (int i = 0; i < 4; ++i) {
+                    line[x + i] = 0xFF000000u | (static_cast<uint>(m_lut[values[i]]) * 0x010101u);
+                }
+            }
+#endif
+            for (; x < width; ++x) {
+                line[x] = applyPixel(line[x]);
+            }
+        } else {
+#ifdef __SSE2__
+            // 每次4个像素：全部不透明时省去逐像素的透明度判断，整块查表后写回。
+            // SSE2没有查表指令，查表有意保持逐字节进行
+            for (; x + 4 <= width; x += 4) {
+                const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(line + x));
+                const __m128i alpha = _mm_and_si128(pixels, alphaMask);
+                if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, alphaMask)) != 0xFFFF) {
+                    for (int i = 0; i < 4; ++i) {
+                        line[x + i] = applyPixel(line[x + i]);
+                    }
+                    continue;
+                }
+
+                // 每个通道使用同一张表，字节顺序无关；透明度字节保持0xFF
+                alignas(16) uchar bytes[16];
+                _mm_store_si128(reinterpret_cast<__m128i*>(bytes), pixels);
+                for (int i = 0; i < 16; i += 4) {
+                    bytes[i] = m_lut[bytes[i]];
+                    bytes[i + 1] = m_lut[bytes[i + 1]];
+                    bytes[i + 2] = m_lut[bytes[i + 2]];
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(line + x),
+                                 _mm_load_si128(reinterpret_cast<const __m128i*>(bytes)));
+            }
+#endif
+            for (; x < width; ++x) {
+                const QRgb pixel = line[x];
+                if (qAlpha(pixel) == 255) {
+                    line[x] = qRgb(m_lut[qRed(pixel)], m_lut[qGreen(pixel)], m_lut[qBlue(pixel)]);
+                } else {
+                    line[x] = applyPixel(pixel);
+                }
+            }
+        }
+    }
+}
+
+QRgb ImageEffects::applyPixel(QRgb pixel) const
+{
+    const int alpha = qAlpha(pixel);
+    if (alpha == 0) {
+        return pixel;
+    }
+
+    // 查找表作用于非预乘的颜色
+    const QRgb color = alpha == 255 ? pixel : qUnpremultiply(pixel);
+    int r = qRed(color);
+    int g = qGreen(color);
+    int b = qBlue(color);
+
+    if (m_grayScale) {
+        r = g = b = qGray(r, g, b);
+    }
+
+    const QRgb result = qRgba(m_lut[r], m_lut[g], m_lut[b], alpha);
+    return alpha == 255 ? result : qPremultiply(result);
+}
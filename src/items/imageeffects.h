@@ -0,0 +1,62 @@
+#ifndef IMAGEEFFECTS_H
+#define IMAGEEFFECTS_H
+
+#include <QImage>
+
+/**
+ * @brief 图像效果（灰度、亮度、对比度）
+ *
+ * 亮度和对比度对每个通道使用同一条曲线，构造时合并为一张256项查找表，
+ * 处理时每个像素只需查表。图像转换为32位预乘格式后按扫描线原地处理：
+ * - 不透明像素直接查表；SSE2下每次判断4个像素的透明度，灰度每次计算4个像素
+ * - 半透明像素先反预乘，处理后再预乘，保留透明度
+ * - 大图像按行带分给线程池并行处理，调用线程同样领取行带
+ *
+ * 对象只保存参数和查找表，可以按值捕获到工作线程中使用。
+ */
+class ImageEffects
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param grayScale 是否灰度
+     * @param brightness 亮度调整（-100到100）
+     * @param contrast 对比度调整（-100到100）
+     */
+    ImageEffects(bool grayScale, int brightness, int contrast);
+
+    /**
+     * @brief 是否不改变图像
+     * @return 没有任何效果时返回true
+     */
+    bool isIdentity() const;
+
+    /**
+     * @brief 应用效果
+     * @param source 原始图像
+     * @return 处理后的图像（有透明通道时为ARGB32预乘格式，否则为RGB32），原始图像为空时为空
+     */
+    QImage apply(const QImage &source) const;
+
+private:
+    /**
+     * @brief 处理若干行
+     * @param image 图像（32位格式）
+     * @param first 起始行
+     * @param last 结束行（不含）
+     */
+    void applyRows(QImage *image, int first, int last) const;
+
+    /**
+     * @brief 处理单个像素
+     * @param pixel 预乘像素
+     * @return 处理后的预乘像素
+     */
+    QRgb applyPixel(QRgb pixel) const;
+
+    bool m_grayScale;       ///< 是否灰度
+    bool m_identityLut;     ///< 查找表是否为恒等映射
+    uchar m_lut[256];       ///< 亮度和对比度查找表
+};
+
+#endif // IMAGEEFFECTS_H
@@ -1,4 +1,5 @@
 #include "imageitem.h"
+#include "imageeffects.h"
 
 #include <QPainter>
 #include <QGraphicsSceneMouseEvent>
@@ -61,6 +62,11 @@ void ImageItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
     // 设置不透明度
     painter->setOpacity(m_opacity);
 
+    // 导出和打印时不等待后台结果
+    if (!widget && m_generator.isPending()) {
+        applyEffects(false);
+    }
+
     // 如果有图像，绘制图像
     if (!m_pixmap.isNull()) {
         painter->drawPixmap(m_rect, m_pixmap, m_pixmap.rect());
@@ -181,7 +187,7 @@ bool ImageItem::loadFromXml(const QDomElement &element)
     }
 
     // 更新内容
-    updateContent();
+    invalidateContent();
 
     return true;
 }
@@ -280,7 +286,7 @@ bool ImageItem::fromJson(const QJsonObject &json)
     }
 
     // 更新内容
-    updateContent();
+    invalidateContent();
 
     return true;
 }
@@ -311,7 +317,7 @@ LabelItem* ImageItem::clone() const
     clone->m_contrast = m_contrast;
 
     // 更新内容
-    clone->updateContent();
+    clone->invalidateContent();
 
     return clone;
 }
@@ -374,8 +380,8 @@ bool ImageItem::setImage(const QImage &image)
     // 保存原始图像
     m_originalImage = image;
 
-    // 应用效果
-    applyEffects();
+    // 标记需要重新应用效果
+    invalidateContent();
 
     // 标记为已修改
     setModified(true);
@@ -386,6 +392,14 @@ bool ImageItem::setImage(const QImage &image)
 
 QImage ImageItem::image() const
 {
+    flushContent();
+
+    // 后台处理尚未完成时直接按当前参数处理，结果到达后由生成器更新元素
+    if (m_generator.isPending()) {
+        const ImageEffects effects = currentEffects();
+        return effects.isIdentity() ? m_originalImage : effects.apply(m_originalImage);
+    }
+
     return m_processedImage.isNull() ? m_originalImage : m_processedImage;
 }
 
@@ -483,7 +497,7 @@ void ImageItem::setGrayScale(bool gray)
     }
 
     m_grayScale = gray;
-    applyEffects();
+    invalidateContent();
     setModified(true);
     emit grayScaleChanged(gray);
     emit itemChanged();
@@ -583,7 +597,7 @@ void ImageItem::adjustBrightness(int brightness)
 
     // 确保亮度在有效范围内
     m_brightness = qBound(-100, brightness, 100);
-    applyEffects();
+    invalidateContent();
     setModified(true);
     emit itemChanged();
 }
@@ -596,7 +610,7 @@ void ImageItem::adjustContrast(int contrast)
 
     // 确保对比度在有效范围内
     m_contrast = qBound(-100, contrast, 100);
-    applyEffects();
+    invalidateContent();
     setModified(true);
     emit itemChanged();
 }
@@ -613,6 +627,7 @@ void ImageItem::resetImage()
     m_contrast = 0;
 
     // 更新图像
+    m_generator.cancel();
     m_processedImage = QImage();
     m_pixmap = QPixmap::fromImage(m_originalImage);
 
@@ -650,65 +665,51 @@ void ImageItem::resize(qreal width, qreal height)
     LabelItem::resize(width, height);
 }
 
-void ImageItem::applyEffects()
+void ImageItem::applyEffects(bool allowAsync)
 {
     if (m_originalImage.isNull()) {
+        m_generator.cancel();
         return;
     }
 
+    const ImageEffects effects = currentEffects();
+
     // 如果没有任何效果，直接使用原始图像
-    if (!m_grayScale && m_brightness == 0 && m_contrast == 0) {
+    if (effects.isIdentity()) {
+        m_generator.cancel();
         m_processedImage = QImage();
         m_pixmap = QPixmap::fromImage(m_originalImage);
         update();
         return;
     }
 
-    // 创建处理后的图像副本
-    m_processedImage = m_originalImage.copy();
+    // 按值捕获参数，任务可以在工作线程中执行
+    const QImage source = m_originalImage;
+    auto task = [=]() {
+        return effects.apply(source);
+    };
 
-    // 应用灰度效果
-    if (m_grayScale) {
-        for (int y = 0; y < m_processedImage.height(); ++y) {
-            QRgb *line = reinterpret_cast<QRgb*>(m_processedImage.scanLine(y));
-            for (int x = 0; x < m_processedImage.width(); ++x) {
-                int gray = qGray(line[x]);
-                line[x] = qRgb(gray, gray, gray);
-            }
-        }
+    // 编辑时在后台处理（拖动滑块时过期的结果由生成器丢弃）
+    if (allowAsync && scene() && SymbolGenerator::canRunAsync()) {
+        m_generator.start(this, task, [this](const QImage &image) {
+            setProcessedImage(image);
+        });
+        return;
     }
 
-    // 应用亮度和对比度调整
-    if (m_brightness != 0 || m_contrast != 0) {
-        // 亮度和对比度因子
-        qreal brightnessF = 1.0 + m_brightness / 100.0;
-        qreal contrastF = 1.0 + m_contrast / 100.0;
-
-        for (int y = 0; y < m_processedImage.height(); ++y) {
-            QRgb *line = reinterpret_cast<QRgb*>(m_processedImage.scanLine(y));
-            for (int x = 0; x < m_processedImage.width(); ++x) {
-                int r = qRed(line[x]);
-                int g = qGreen(line[x]);
-                int b = qBlue(line[x]);
-
-                // 应用亮度
-                if (m_brightness != 0) {
-                    r = qBound(0, static_cast<int>(r * brightnessF), 255);
-                    g = qBound(0, static_cast<int>(g * brightnessF), 255);
-                    b = qBound(0, static_cast<int>(b * brightnessF), 255);
-                }
-
-                // 应用对比度
-                if (m_contrast != 0) {
-                    r = qBound(0, static_cast<int>(((r / 255.0 - 0.5) * contrastF + 0.5) * 255), 255);
-                    g = qBound(0, static_cast<int>(((g / 255.0 - 0.5) * contrastF + 0.5) * 255), 255);
-                    b = qBound(0, static_cast<int>(((b / 255.0 - 0.5) * contrastF + 0.5) * 255), 255);
-                }
-
-                line[x] = qRgba(r, g, b, qAlpha(line[x]));
-            }
-        }
-    }
+    m_generator.cancel();
+    setProcessedImage(task());
+}
+
+ImageEffects ImageItem::currentEffects() const
+{
+    // 亮度和对比度合并为查找表
+    return ImageEffects(m_grayScale, m_brightness, m_contrast);
+}
+
+void ImageItem::setProcessedImage(const QImage &image)
+{
+    m_processedImage = image;
 
     // 更新像素图
     m_pixmap = QPixmap::fromImage(m_processedImage);
@@ -2,12 +2,15 @@
 #define IMAGEITEM_H
 
 #include "labelitem.h"
+#include "symbolgenerator.h"
 
 #include <QPixmap>
 #include <QImage>
 #include <QColor>
 #include <QString>
 
+class ImageEffects;
+
 /**
  * @brief 图像元素类
  *
@@ -207,9 +210,24 @@ private:
     /**
      * @brief 应用图像效果
      *
-     * 根据当前设置应用灰度、亮度和对比度等效果
+     * 根据当前设置应用灰度、亮度和对比度等效果。
+     * 在场景中编辑时于后台处理，结果到达前继续显示上一张图像
+     *
+     * @param allowAsync 是否允许后台处理
+     */
+    void applyEffects(bool allowAsync = true);
+
+    /**
+     * @brief 按当前设置构造图像效果
+     * @return 灰度、亮度和对比度效果
+     */
+    ImageEffects currentEffects() const;
+
+    /**
+     * @brief 设置处理后的图像并更新像素图
+     * @param image 处理后的图像
      */
-    void applyEffects();
+    void setProcessedImage(const QImage &image);
 
     /**
      * @brief 保存原始图像
@@ -230,6 +248,7 @@ private:
     bool m_grayScale;           ///< 是否灰度显示
     int m_brightness;           ///< 亮度调整
     int m_contrast;             ///< 对比度调整
+    SymbolGenerator m_generator; ///< 后台效果处理器
 
 signals:
     /**
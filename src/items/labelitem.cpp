@@ -17,6 +17,9 @@ LabelItem::LabelItem(QGraphicsItem *parent)
     , m_visible(true)
     , m_modified(false)
     , m_hovered(false)
+    , m_contentDirty(false)
+    , m_flushPending(false)
+    , m_updateDepth(0)
     , m_dragging(false)
     , m_activeHandle(-1)
 {
@@ -70,6 +73,9 @@ void LabelItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
 {
     Q_UNUSED(widget)
 
+    // 子类绘制前先调用本方法，确保内容是最新的
+    flushContent();
+
     // 保存当前状态
     painter->save();
 
@@ -258,6 +264,57 @@ bool LabelItem::isModified() const
     return m_modified;
 }
 
+void LabelItem::beginUpdate()
+{
+    ++m_updateDepth;
+}
+
+void LabelItem::endUpdate()
+{
+    if (m_updateDepth <= 0) {
+        return;
+    }
+
+    if (--m_updateDepth == 0) {
+        flushContent();
+    }
+}
+
+void LabelItem::flushContent() const
+{
+    if (!m_contentDirty) {
+        return;
+    }
+
+    LabelItem *self = const_cast<LabelItem*>(this);
+    self->m_contentDirty = false;
+    self->updateContent();
+}
+
+bool LabelItem::isContentDirty() const
+{
+    return m_contentDirty;
+}
+
+void LabelItem::invalidateContent()
+{
+    m_contentDirty = true;
+    update();
+
+    if (m_updateDepth > 0 || m_flushPending) {
+        return;
+    }
+
+    // 在元素所属线程的下一次事件循环中统一更新
+    m_flushPending = true;
+    QMetaObject::invokeMethod(this, [this]() {
+        m_flushPending = false;
+        if (m_updateDepth == 0) {
+            flushContent();
+        }
+    }, Qt::QueuedConnection);
+}
+
 void LabelItem::moveBy(qreal dx, qreal dy)
 {
     QPointF newPos = position() + QPointF(dx, dy);
@@ -575,6 +632,23 @@ void LabelItem::drawHandles(QPainter *painter) const
     painter->drawEllipse(rotateHandle, HandleSize/2, HandleSize/2);
 }
 
+// ============ LabelItem::UpdateScope 实现 ============
+
+LabelItem::UpdateScope::UpdateScope(LabelItem *item)
+    : m_item(item)
+{
+    if (m_item) {
+        m_item->beginUpdate();
+    }
+}
+
+LabelItem::UpdateScope::~UpdateScope()
+{
+    if (m_item) {
+        m_item->endUpdate();
+    }
+}
+
 // ============ MoveItemCommand 实现 ============
 
 MoveItemCommand::MoveItemCommand(LabelItem *item, const QPointF &oldPos, const QPointF &newPos)
@@ -233,7 +233,69 @@ public:
      */
     virtual void updateContent() = 0;
 
+    // 延迟更新
+
+    /**
+     * @brief 开始批量修改
+     *
+     * 直到对应的endUpdate()之前，属性修改只标记内容失效，不重新生成
+     */
+    void beginUpdate();
+
+    /**
+     * @brief 结束批量修改
+     *
+     * 最外层结束时，如果内容已失效则立即重新生成一次
+     */
+    void endUpdate();
+
+    /**
+     * @brief 如果内容已失效，立即重新生成
+     *
+     * 绘制前自动调用；没有事件循环的线程中读取生成结果前也应调用
+     */
+    void flushContent() const;
+
+    /**
+     * @brief 判断内容是否已失效
+     * @return 如果等待重新生成则返回true
+     */
+    bool isContentDirty() const;
+
+    /**
+     * @brief 批量修改作用域
+     *
+     * 构造时调用beginUpdate()，析构时调用endUpdate()
+     */
+    class UpdateScope
+    {
+    public:
+        /**
+         * @brief 构造函数
+         * @param item 标签元素
+         */
+        explicit UpdateScope(LabelItem *item);
+
+        /**
+         * @brief 析构函数
+         */
+        ~UpdateScope();
+
+    private:
+        Q_DISABLE_COPY(UpdateScope)
+
+        LabelItem *m_item;  ///< 标签元素
+    };
+
 protected:
+    /**
+     * @brief 标记内容失效
+     *
+     * 同一事件循环周期内的多次修改合并为一次updateContent()，
+     * 在下一次事件循环、批量修改结束或绘制前（先到者）执行
+     */
+    void invalidateContent();
+
     // 鼠标事件处理
     void mousePressEvent(QGraphicsSceneMouseEvent *event) override;
     void mouseMoveEvent(QGraphicsSceneMouseEvent *event) override;
@@ -278,6 +340,11 @@ protected:
     bool m_modified;          ///< 元素是否已修改
     bool m_hovered;           ///< 鼠标是否悬停在元素上
 
+    // 延迟更新状态变量
+    bool m_contentDirty;      ///< 内容是否已失效
+    bool m_flushPending;      ///< 是否已安排在事件循环中更新
+    int m_updateDepth;        ///< 批量修改的嵌套层数
+
     // 拖动状态变量
     bool m_dragging;          ///< 是否正在拖动
     int m_activeHandle;       ///< 当前活动的控制点
@@ -1,6 +1,11 @@
 #include "qrcodeitem.h"
+#include "qrcodematrixcache.h"
+#include "qrencoder.h"
+#include "qrsegmentoptimizer.h"
 
 #include <QPainter>
+#include <QPaintEngine>
+#include <QPainterPath>
 #include <QGraphicsSceneMouseEvent>
 #include <QInputDialog>
 #include <QDebug>
@@ -9,6 +14,9 @@
 #include <QJsonObject>
 #include <QUuid>
 
+#include <atomic>
+#include <memory>
+
 // 集成QRencode库
 #include <qrencode.h>
 
@@ -28,6 +36,76 @@ static const QMap<QRErrorCorrectionLevel, QRecLevel> qrencodeECLevelMap = {
     {QRErrorCorrectionLevel::High, QR_ECLEVEL_H}
 };
 
+// 分段模式映射
+static QRencodeMode qrencodeMode(QRSegmentOptimizer::Mode mode)
+{
+    switch (mode) {
+        case QRSegmentOptimizer::NumericMode:
+            return QR_MODE_NUM;
+        case QRSegmentOptimizer::AlphanumericMode:
+            return QR_MODE_AN;
+        case QRSegmentOptimizer::KanjiMode:
+            return QR_MODE_KANJI;
+        default:
+            return QR_MODE_8;
+    }
+}
+
+// 全局使用的编码器
+static std::atomic<int> encoderBackendSetting(static_cast<int>(QREncoderBackend::LibQREncode));
+
+// 按分段编码，选择能容纳数据的最小版本，返回版本（失败时为0）
+static int encodeSegments(const QVector<QRSegmentOptimizer::Segment> &segments, QRErrorCorrectionLevel level,
+                          QREncoderBackend backend, QRCodeMatrix *matrix)
+{
+    if (segments.isEmpty()) {
+        return 0;
+    }
+
+    if (backend == QREncoderBackend::Builtin) {
+        // 每个线程一个编码器，工作区重复使用
+        static thread_local std::unique_ptr<QREncoder> encoder;
+        if (!encoder) {
+            encoder.reset(new QREncoder());
+        }
+        return encoder->encode(segments, level, matrix);
+    }
+
+    // 版本为0时由QRencode自动选择
+    QRinput *input = QRinput_new2(0, qrencodeECLevelMap.value(level, QR_ECLEVEL_M));
+    if (!input) {
+        return 0;
+    }
+
+    for (const QRSegmentOptimizer::Segment &segment : segments) {
+        const int result = QRinput_append(input, qrencodeMode(segment.mode), segment.data.size(),
+                                          reinterpret_cast<const unsigned char*>(segment.data.constData()));
+        if (result != 0) {
+            QRinput_free(input);
+            return 0;
+        }
+    }
+
+    QRcode *qrCode = QRcode_encodeInput(input);
+    QRinput_free(input);
+    if (!qrCode) {
+        return 0;
+    }
+
+    // QRcode数据每个模块一个字节，最低位表示深色，其余位是内部标记
+    const int width = qrCode->width;
+    QByteArray modules(width * width, Qt::Uninitialized);
+    for (int i = 0; i < modules.size(); ++i) {
+        modules[i] = static_cast<char>(qrCode->data[i] & 0x01);
+    }
+
+    const int version = qrCode->version;
+    QRcode_free(qrCode);
+
+    *matrix = QRCodeMatrix(width, modules);
+    return version;
+}
+
 QRCodeItem::QRCodeItem(QGraphicsItem *parent)
     : LabelItem(parent)
     , m_data("https://example.com")
@@ -47,8 +125,8 @@ QRCodeItem::QRCodeItem(QGraphicsItem *parent)
     // 设置默认大小
     setSize(QSizeF(200, 200));
 
-    // 生成二维码图像
-    generateQRCodeImage();
+    // 标记二维码图像需要重新生成
+    invalidateContent();
 }
 
 QRCodeItem::QRCodeItem(const QString &data, QGraphicsItem *parent)
@@ -57,7 +135,7 @@ QRCodeItem::QRCodeItem(const QString &data, QGraphicsItem *parent)
     m_data = data;
 
     // 更新二维码内容
-    updateContent();
+    invalidateContent();
 }
 
 QRCodeItem::~QRCodeItem()
@@ -81,10 +159,30 @@ void QRCodeItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option
     // 绘制背景
     painter->fillRect(m_rect, m_backgroundColor);
 
-    // 如果有二维码图像，绘制图像
-    if (!m_qrCodeImage.isNull()) {
-        painter->drawImage(m_rect, m_qrCodeImage, m_qrCodeImage.rect());
-    } else {
+    bool painted = false;
+    if (!widget) {
+        const QPaintEngine *engine = painter->paintEngine();
+        if (engine && engine->type() == QPaintEngine::Raster) {
+            // 导出位图和光栅化打印：输出像素已知，模块按像素取整
+            const QRCodeMatrix matrix = QRCodeMatrix::encode(m_data, m_errorLevel);
+            painted = paintImage(painter, symbolImage(matrix, m_foregroundColor, m_backgroundColor));
+        } else {
+            // PDF和打印机直接绘制矢量路径，任意分辨率下都精确，也不必嵌入图像
+            painted = paintVector(painter);
+        }
+
+        // 直接绘制失败才需要图像，此时不能等待后台结果
+        if (!painted && m_generator.isPending()) {
+            generateQRCodeImage(false);
+        }
+    }
+
+    if (!painted) {
+        // 屏幕上绘制后台生成的图像
+        painted = paintImage(painter, m_qrCodeImage);
+    }
+
+    if (!painted) {
         // 没有二维码时绘制占位符
         painter->setPen(Qt::gray);
         painter->setBrush(Qt::lightGray);
@@ -154,8 +252,8 @@ bool QRCodeItem::loadFromXml(const QDomElement &element)
     m_size = element.attribute("size", "200").toInt();
     m_quietZone = element.attribute("quietZone", "true") == "true";
 
-    // 生成二维码图像
-    generateQRCodeImage();
+    // 标记二维码图像需要重新生成
+    invalidateContent();
 
     return true;
 }
@@ -219,8 +317,8 @@ bool QRCodeItem::fromJson(const QJsonObject &json)
     m_size = json["size"].toInt(200);
     m_quietZone = json["quietZone"].toBool(true);
 
-    // 生成二维码图像
-    generateQRCodeImage();
+    // 标记二维码图像需要重新生成
+    invalidateContent();
 
     return true;
 }
@@ -246,8 +344,8 @@ LabelItem* QRCodeItem::clone() const
     clone->m_size = m_size;
     clone->m_quietZone = m_quietZone;
 
-    // 生成二维码图像
-    clone->generateQRCodeImage();
+    // 内容在下一次事件循环或首次绘制时生成
+    clone->invalidateContent();
 
     return clone;
 }
@@ -268,7 +366,7 @@ void QRCodeItem::setData(const QString &data)
     }
 
     m_data = data;
-    generateQRCodeImage();
+    invalidateContent();
     setModified(true);
     emit dataChanged(data);
     emit itemChanged();
@@ -286,7 +384,7 @@ void QRCodeItem::setErrorCorrectionLevel(QRErrorCorrectionLevel level)
     }
 
     m_errorLevel = level;
-    generateQRCodeImage();
+    invalidateContent();
     setModified(true);
     emit errorCorrectionLevelChanged(level);
     emit itemChanged();
@@ -304,7 +402,7 @@ void QRCodeItem::setForegroundColor(const QColor &color)
     }
 
     m_foregroundColor = color;
-    generateQRCodeImage();
+    invalidateContent();
     setModified(true);
     emit foregroundColorChanged(color);
     emit itemChanged();
@@ -322,7 +420,7 @@ void QRCodeItem::setBackgroundColor(const QColor &color)
     }
 
     m_backgroundColor = color;
-    generateQRCodeImage();
+    invalidateContent();
     setModified(true);
     emit backgroundColorChanged(color);
     emit itemChanged();
@@ -340,7 +438,7 @@ void QRCodeItem::setMargin(int margin)
     }
 
     m_margin = margin;
-    generateQRCodeImage();
+    invalidateContent();
     setModified(true);
     emit marginChanged(margin);
     emit itemChanged();
@@ -362,7 +460,7 @@ void QRCodeItem::setSize(int size)
     // 更新元素大小（保持正方形）
     LabelItem::setSize(QSizeF(size, size));
 
-    generateQRCodeImage();
+    invalidateContent();
     setModified(true);
     emit sizeChanged(size);
     emit itemChanged();
@@ -380,7 +478,7 @@ void QRCodeItem::setQuietZone(bool quietZone)
     }
 
     m_quietZone = quietZone;
-    generateQRCodeImage();
+    invalidateContent();
     setModified(true);
     emit quietZoneChanged(quietZone);
     emit itemChanged();
@@ -401,6 +499,57 @@ QRErrorCorrectionLevel QRCodeItem::getErrorCorrectionLevelFromName(const QString
     return qrErrorCorrectionLevelNames.key(name, QRErrorCorrectionLevel::Medium);
 }
 
+int QRCodeItem::moduleCount(const QString &data, QRErrorCorrectionLevel errorCorrectionLevel)
+{
+    return QRCodeMatrix::encode(data, errorCorrectionLevel).width();
+}
+
+QRCodeMatrix QRCodeItem::encodeMatrix(const QString &data, QRErrorCorrectionLevel level,
+                                      QREncoderBackend backend)
+{
+    if (data.isEmpty()) {
+        return QRCodeMatrix();
+    }
+
+    // 字符计数字段的位数随版本区间变化，从小到大按每个区间优化分段；
+    // 结果落在该区间内时就是最小版本，否则保留较小的结果继续尝试下一个区间
+    static const int versionGroupEnds[] = {9, 26, 40};
+
+    QRCodeMatrix matrix;
+    int version = 0;
+    for (int groupEnd : versionGroupEnds) {
+        QRCodeMatrix candidate;
+        const int candidateVersion = encodeSegments(QRSegmentOptimizer::optimize(data, groupEnd),
+                                                    level, backend, &candidate);
+        if (candidateVersion <= 0) {
+            continue;
+        }
+
+        if (version == 0 || candidateVersion < version) {
+            matrix = candidate;
+            version = candidateVersion;
+        }
+
+        if (version <= groupEnd) {
+            break;
+        }
+    }
+
+    return matrix;
+}
+
+void QRCodeItem::setEncoderBackend(QREncoderBackend backend)
+{
+    if (encoderBackendSetting.exchange(static_cast<int>(backend)) != static_cast<int>(backend)) {
+        QRCodeMatrixCache::instance()->clear();
+    }
+}
+
+QREncoderBackend QRCodeItem::encoderBackend()
+{
+    return static_cast<QREncoderBackend>(encoderBackendSetting.load());
+}
+
 QImage QRCodeItem::generateQRCode(const QString &data,
                                 QRErrorCorrectionLevel errorCorrectionLevel,
                                 int size,
@@ -414,50 +563,32 @@ QImage QRCodeItem::generateQRCode(const QString &data,
     qrImage.fill(background);
 
     try {
-        // 使用QRencode库生成二维码
-        QRecLevel qrLevel = qrencodeECLevelMap.value(errorCorrectionLevel, QR_ECLEVEL_M);
-
-        // 设置QRcode的版本，0表示自动选择
-        QRcode *qrCode = QRcode_encodeString(data.toUtf8().constData(), 0, qrLevel, QR_MODE_8, 1);
+        // 模块矩阵来自全局缓存，只改颜色、尺寸或边距时不会重新编码
+        const QRCodeMatrix matrix = QRCodeMatrix::encode(data, errorCorrectionLevel);
 
-        if (!qrCode) {
+        if (!matrix.isValid()) {
             throw std::runtime_error("QR码生成失败");
         }
 
-        // 创建画家
-        QPainter painter(&qrImage);
-        painter.setPen(Qt::NoPen);
-        painter.setBrush(foreground);
-
-        // 计算模块大小（不包括边距）
-        double moduleSize = (size - 2.0 * margin) / qrCode->width;
-
-        // 绘制QR码
-        for (int y = 0; y < qrCode->width; y++) {
-            for (int x = 0; x < qrCode->width; x++) {
-                // QRcode数据是按行存储的一维数组，用位运算检查状态
-                unsigned char bit = qrCode->data[y * qrCode->width + x];
-                if (bit & 0x01) {  // 检查最低位
-                    QRectF rect(margin + x * moduleSize,
-                               margin + y * moduleSize,
-                               moduleSize, moduleSize);
-                    painter.drawRect(rect);
-                }
-            }
+        // 模块取整数个像素时直接写入扫描线，不足一个像素时按小数尺寸绘制，不超出边距
+        const QRectF area = symbolArea(QRectF(0, 0, size, size), margin);
+        const QRect snapped = snapModules(area, matrix.width());
+        if (!snapped.isEmpty()) {
+            matrix.rasterize(&qrImage, snapped.topLeft(), snapped.width() / matrix.width(), foreground.rgba());
+        } else if (!area.isEmpty()) {
+            QPainter painter(&qrImage);
+            painter.fillPath(matrix.toPath(area), foreground);
         }
 
         // 如果需要安静区（quiet zone），绘制边框
-        if (quietZone) {
+        if (quietZone && !area.isEmpty()) {
+            const QRectF symbol = snapped.isEmpty() ? area : QRectF(snapped);
+            QPainter painter(&qrImage);
             painter.setPen(QPen(Qt::lightGray, 1, Qt::DashLine));
             painter.setBrush(Qt::NoBrush);
-            double quietZoneWidth = qrCode->width * moduleSize;
-            painter.drawRect(margin - 4, margin - 4,
-                           quietZoneWidth + 8, quietZoneWidth + 8);
+            painter.drawRect(symbol.adjusted(-4, -4, 4, 4));
         }
 
-        // 释放QR码
-        QRcode_free(qrCode);
-
         return qrImage;
     }
     catch (const std::exception &e) {
@@ -555,19 +686,143 @@ void QRCodeItem::mouseDoubleClickEvent(QGraphicsSceneMouseEvent *event)
     }
 }
 
-bool QRCodeItem::generateQRCodeImage()
+QRectF QRCodeItem::symbolArea(const QRectF &rect, qreal margin)
+{
+    const qreal side = qMin(rect.width(), rect.height()) - 2 * margin;
+    if (side <= 0) {
+        return QRectF();
+    }
+
+    QRectF area(0, 0, side, side);
+    area.moveCenter(rect.center());
+    return area;
+}
+
+QRect QRCodeItem::snapModules(const QRectF &area, int modules)
+{
+    if (modules <= 0 || area.isEmpty()) {
+        return QRect();
+    }
+
+    // 容许浮点误差，边长恰为模块数整数倍时不丢掉一个像素
+    const int moduleSize = static_cast<int>(qMin(area.width(), area.height()) / modules + 1e-6);
+    if (moduleSize < 1) {
+        return QRect();
+    }
+
+    const int side = moduleSize * modules;
+    const QPointF center = area.center();
+    return QRect(qRound(center.x() - side / 2.0), qRound(center.y() - side / 2.0), side, side);
+}
+
+QImage QRCodeItem::symbolImage(const QRCodeMatrix &matrix, const QColor &foreground, const QColor &background)
+{
+    // 每个模块一个像素，绘制时再按设备像素放大
+    QImage image = matrix.toImage(1, 0, QImage::Format_Indexed8);
+    if (!image.isNull()) {
+        image.setColorTable(QVector<QRgb>() << background.rgba() << foreground.rgba());
+    }
+    return image;
+}
+
+bool QRCodeItem::paintImage(QPainter *painter, const QImage &image) const
+{
+    const QRectF area = symbolArea(m_rect, m_margin);
+    if (image.isNull() || area.isEmpty()) {
+        return false;
+    }
+
+    painter->save();
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, false);
+
+    // 只有缩放和平移时在设备坐标中绘制，每个模块取整数个设备像素；
+    // 旋转时按小数尺寸绘制
+    const QTransform device = painter->deviceTransform();
+    const QRect snapped = device.type() <= QTransform::TxScale
+                          ? snapModules(device.mapRect(area), image.width()) : QRect();
+    if (!snapped.isEmpty()) {
+        painter->setWorldTransform(device.inverted() * painter->worldTransform());
+        painter->drawImage(snapped, image);
+    } else {
+        painter->drawImage(area, image);
+    }
+
+    painter->restore();
+
+    // 如果需要安静区（quiet zone），绘制边框
+    if (m_quietZone) {
+        painter->save();
+        painter->setPen(QPen(Qt::lightGray, 0, Qt::DashLine));
+        painter->setBrush(Qt::NoBrush);
+        painter->drawRect(area.adjusted(-4, -4, 4, 4));
+        painter->restore();
+    }
+
+    return true;
+}
+
+bool QRCodeItem::paintVector(QPainter *painter) const
+{
+    // 按小数尺寸布局，不取整：矢量输出在设备上才决定像素
+    const QRectF area = symbolArea(m_rect, m_margin);
+    if (m_data.isEmpty() || area.isEmpty()) {
+        return false;
+    }
+
+    const QRCodeMatrix matrix = QRCodeMatrix::encode(m_data, m_errorLevel);
+    if (!matrix.isValid()) {
+        return false;
+    }
+
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing, false);
+
+    // 所有深色模块一次填充
+    painter->fillPath(matrix.toPath(area), m_foregroundColor);
+
+    // 如果需要安静区（quiet zone），绘制边框
+    if (m_quietZone) {
+        painter->setPen(QPen(Qt::lightGray, 0, Qt::DashLine));
+        painter->setBrush(Qt::NoBrush);
+        painter->drawRect(area.adjusted(-4, -4, 4, 4));
+    }
+
+    painter->restore();
+    return true;
+}
+
+bool QRCodeItem::generateQRCodeImage(bool allowAsync)
 {
     // 确保数据和尺寸有效
     if (m_data.isEmpty() || m_rect.width() < 10 || m_rect.height() < 10) {
+        m_generator.cancel();
         m_qrCodeImage = QImage();
         return false;
     }
 
+    // 按值捕获参数，任务可以在工作线程中执行。
+    // 图像每个模块一个像素，尺寸和边距在绘制时按设备像素处理，改变尺寸不必重新生成
+    const QString data = m_data;
+    const QRErrorCorrectionLevel level = m_errorLevel;
+    const QColor foreground = m_foregroundColor;
+    const QColor background = m_backgroundColor;
+
+    auto task = [=]() {
+        return symbolImage(QRCodeMatrix::encode(data, level), foreground, background);
+    };
+
+    // 编辑时在后台生成，过期的结果由生成器丢弃
+    if (allowAsync && scene() && SymbolGenerator::canRunAsync()) {
+        m_generator.start(this, task, [this](const QImage &image) {
+            m_qrCodeImage = image;
+            update();
+        });
+        return true;
+    }
+
     // 生成二维码图像
-    m_qrCodeImage = generateQRCode(m_data, m_errorLevel,
-                                  qMin(m_rect.width(), m_rect.height()), // 取最小的边长确保是正方形
-                                  m_margin, m_foregroundColor, m_backgroundColor,
-                                  m_quietZone);
+    m_generator.cancel();
+    m_qrCodeImage = task();
 
     // 更新视图
     update();
@@ -2,6 +2,8 @@
 #define QRCODEITEM_H
 
 #include "labelitem.h"
+#include "qrcodematrix.h"
+#include "symbolgenerator.h"
 
 #include <QColor>
 #include <QString>
@@ -17,6 +19,14 @@ enum class QRErrorCorrectionLevel {
     High        ///< 高级别错误校正（约30%）
 };
 
+/**
+ * @brief 二维码编码器
+ */
+enum class QREncoderBackend {
+    LibQREncode,    ///< QRencode库
+    Builtin         ///< 内置编码器（查表Reed-Solomon、无分配工作区、按字计算掩码惩罚）
+};
+
 /**
  * @brief 二维码元素类
  *
@@ -180,8 +190,75 @@ public:
      */
     static QRErrorCorrectionLevel getErrorCorrectionLevelFromName(const QString &name);
 
+    /**
+     * @brief 获取错误校正级别字符
+     * @param level 错误校正级别
+     * @return 级别字符（L、M、Q、H）
+     */
+    static char getErrorCorrectionLevelChar(QRErrorCorrectionLevel level);
+
+    /**
+     * @brief 计算二维码每边的模块数
+     * @param data 二维码数据
+     * @param errorCorrectionLevel 错误校正级别
+     * @return 模块数（不含静区），无法编码时返回0
+     */
+    static int moduleCount(const QString &data, QRErrorCorrectionLevel errorCorrectionLevel);
+
+    /**
+     * @brief 编码二维码矩阵（不经过缓存）
+     * @param data 二维码数据
+     * @param level 错误校正级别
+     * @param backend 编码器
+     * @return 矩阵，无法编码时无效
+     */
+    static QRCodeMatrix encodeMatrix(const QString &data, QRErrorCorrectionLevel level,
+                                     QREncoderBackend backend);
+
+    /**
+     * @brief 设置全局使用的编码器
+     *
+     * 切换时清空矩阵缓存
+     *
+     * @param backend 编码器
+     */
+    static void setEncoderBackend(QREncoderBackend backend);
+
+    /**
+     * @brief 获取全局使用的编码器
+     * @return 编码器
+     */
+    static QREncoderBackend encoderBackend();
+
+    /**
+     * @brief 计算符号区域
+     *
+     * 较短边减去两侧边距得到正方形，在元素矩形中居中。模块按小数尺寸铺满该区域，
+     * 只在已知输出像素（打印点）时由snapModules()取整
+     *
+     * @param rect 元素矩形
+     * @param margin 边距
+     * @return 符号区域（不含静区），边距过大时为空
+     */
+    static QRectF symbolArea(const QRectF &rect, qreal margin);
+
+    /**
+     * @brief 将模块对齐到整数像素
+     *
+     * 每个模块取整数个像素（打印点），对齐后的符号在区域中居中
+     *
+     * @param area 符号区域（像素）
+     * @param modules 每边的模块数
+     * @return 对齐后的符号区域，每个模块不足一个像素时为空
+     */
+    static QRect snapModules(const QRectF &area, int modules);
+
     /**
      * @brief 生成二维码图像
+     *
+     * 模块取整数个像素并居中，逐行写入扫描线；不足一个像素时按小数尺寸绘制。
+     * 纯函数，可以在工作线程中调用
+     *
      * @param data 二维码数据
      * @param errorCorrectionLevel 错误校正级别
      * @param size 尺寸
@@ -209,16 +286,43 @@ protected:
 private:
     /**
      * @brief 生成二维码图像
-     * @return 生成是否成功
+     *
+     * 在场景中编辑时于后台生成，结果到达前继续显示上一张图像
+     *
+     * @param allowAsync 是否允许后台生成
+     * @return 生成是否成功（后台生成时表示已提交）
      */
-    bool generateQRCodeImage();
+    bool generateQRCodeImage(bool allowAsync = true);
 
     /**
-     * @brief 获取错误校正级别字符
-     * @param level 错误校正级别
-     * @return 级别字符
+     * @brief 生成符号图像
+     * @param matrix 模块矩阵
+     * @param foreground 前景色
+     * @param background 背景色
+     * @return 每个模块一个像素的Format_Indexed8图像，矩阵无效时为空
      */
-    static char getErrorCorrectionLevelChar(QRErrorCorrectionLevel level);
+    static QImage symbolImage(const QRCodeMatrix &matrix, const QColor &foreground, const QColor &background);
+
+    /**
+     * @brief 绘制符号图像
+     *
+     * 画家变换只有缩放和平移时，每个模块取整数个设备像素
+     *
+     * @param painter 画家（已应用旋转）
+     * @param image 符号图像（每个模块一个像素）
+     * @return 是否绘制成功
+     */
+    bool paintImage(QPainter *painter, const QImage &image) const;
+
+    /**
+     * @brief 以矢量方式绘制二维码
+     *
+     * 导出PDF和打印时使用，符号区域按小数尺寸铺满元素减去边距的正方形
+     *
+     * @param painter 画家（已应用旋转）
+     * @return 是否绘制成功
+     */
+    bool paintVector(QPainter *painter) const;
 
 private:
     QString m_data;                         ///< 二维码数据
@@ -228,7 +332,8 @@ private:
     int m_margin;                           ///< 边距
     int m_size;                             ///< 尺寸
     bool m_quietZone;                       ///< 是否包含安静区
-    QImage m_qrCodeImage;                   ///< 二维码图像
+    QImage m_qrCodeImage;                   ///< 二维码图像（每个模块一个像素）
+    SymbolGenerator m_generator;            ///< 后台图像生成器
 
 signals:
     /**
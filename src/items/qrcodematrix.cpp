@@ -0,0 +1,229 @@
+#include "qrcodematrix.h"
+#include "qrcodeitem.h"
+#include "qrcodematrixcache.h"
+
+#include <QPainterPath>
+
+#include <algorithm>
+#include <cstring>
+
+// 依次处理一行中连续的深色模块[start, end)
+template <typename Fill>
+static void forEachRun(const uchar *row, int width, Fill fill)
+{
+    int x = 0;
+    while (x < width) {
+        while (x < width && !row[x]) {
+            ++x;
+        }
+        const int start = x;
+        while (x < width && row[x]) {
+            ++x;
+        }
+        if (x > start) {
+            fill(start, x);
+        }
+    }
+}
+
+// 将1位扫描线中[from, to)范围的位置1（高位在前）
+static void setBits(uchar *line, int from, int to)
+{
+    if (from >= to) {
+        return;
+    }
+
+    const int first = from >> 3;
+    const int last = (to - 1) >> 3;
+    const uchar head = static_cast<uchar>(0xff >> (from & 7));
+    const uchar tail = static_cast<uchar>(0xff << (7 - ((to - 1) & 7)));
+
+    if (first == last) {
+        line[first] |= head & tail;
+        return;
+    }
+
+    line[first] |= head;
+    memset(line + first + 1, 0xff, last - first - 1);
+    line[last] |= tail;
+}
+
+QRCodeMatrix::QRCodeMatrix()
+    : m_width(0)
+{
+}
+
+QRCodeMatrix::QRCodeMatrix(int width, const QByteArray &modules)
+    : m_width(width)
+    , m_modules(modules)
+{
+    if (m_width <= 0 || m_modules.size() != m_width * m_width) {
+        m_width = 0;
+        m_modules.clear();
+    }
+}
+
+QRCodeMatrix QRCodeMatrix::encode(const QString &data, QRErrorCorrectionLevel level)
+{
+    if (data.isEmpty()) {
+        return QRCodeMatrix();
+    }
+
+    QRCodeMatrixCache *cache = QRCodeMatrixCache::instance();
+
+    QRCodeMatrix matrix;
+    if (cache->find(data, level, &matrix)) {
+        return matrix;
+    }
+
+    // 编码失败的结果也缓存，避免重复尝试
+    matrix = QRCodeItem::encodeMatrix(data, level, QRCodeItem::encoderBackend());
+    cache->insert(data, level, matrix);
+    return matrix;
+}
+
+bool QRCodeMatrix::isValid() const
+{
+    return m_width > 0;
+}
+
+int QRCodeMatrix::width() const
+{
+    return m_width;
+}
+
+bool QRCodeMatrix::isDark(int x, int y) const
+{
+    if (x < 0 || y < 0 || x >= m_width || y >= m_width) {
+        return false;
+    }
+    return m_modules.at(y * m_width + x) != 0;
+}
+
+const uchar *QRCodeMatrix::row(int y) const
+{
+    return reinterpret_cast<const uchar*>(m_modules.constData()) + y * m_width;
+}
+
+QByteArray QRCodeMatrix::modules() const
+{
+    return m_modules;
+}
+
+int QRCodeMatrix::moduleSize(int pixels, int border) const
+{
+    if (!isValid()) {
+        return 1;
+    }
+    return qMax(1, pixels / (m_width + 2 * qMax(0, border)));
+}
+
+QImage QRCodeMatrix::toImage(int moduleSize, int border, QImage::Format format) const
+{
+    if (!isValid() || moduleSize < 1 || border < 0
+        || (format != QImage::Format_Mono && format != QImage::Format_Indexed8)) {
+        return QImage();
+    }
+
+    const int side = (m_width + 2 * border) * moduleSize;
+    QImage image(side, side, format);
+    if (image.isNull()) {
+        return QImage();
+    }
+    image.setColorTable(QVector<QRgb>() << qRgb(255, 255, 255) << qRgb(0, 0, 0));
+    image.fill(0);
+
+    const bool mono = format == QImage::Format_Mono;
+    const int offset = border * moduleSize;
+    const size_t bytes = mono ? static_cast<size_t>(side + 7) / 8 : static_cast<size_t>(side);
+
+    for (int y = 0; y < m_width; ++y) {
+        // 每行模块只展开到第一条扫描线
+        const int top = offset + y * moduleSize;
+        uchar *line = image.scanLine(top);
+
+        forEachRun(row(y), m_width, [&](int start, int end) {
+            const int x0 = offset + start * moduleSize;
+            const int x1 = offset + end * moduleSize;
+            if (mono) {
+                setBits(line, x0, x1);
+            } else {
+                memset(line + x0, 1, x1 - x0);
+            }
+        });
+
+        // 同一行模块的其余扫描线直接复制
+        for (int i = 1; i < moduleSize; ++i) {
+            memcpy(image.scanLine(top + i), line, bytes);
+        }
+    }
+
+    return image;
+}
+
+void QRCodeMatrix::rasterize(QImage *image, const QPoint &origin, int moduleSize, QRgb color) const
+{
+    if (!image || image->depth() != 32 || !isValid() || moduleSize < 1) {
+        return;
+    }
+
+    const int side = m_width * moduleSize;
+    const QRect area(origin, QSize(side, side));
+    const QRect rect = area.intersected(image->rect());
+    if (rect.isEmpty()) {
+        return;
+    }
+
+    const size_t bytes = static_cast<size_t>(rect.width()) * 4;
+
+    for (int y = 0; y < m_width; ++y) {
+        const int top = qMax(rect.top(), area.top() + y * moduleSize);
+        const int bottom = qMin(rect.bottom() + 1, area.top() + (y + 1) * moduleSize);
+        if (top >= bottom) {
+            continue;
+        }
+
+        // 每行模块只展开到第一条扫描线
+        quint32 *line = reinterpret_cast<quint32*>(image->scanLine(top));
+        forEachRun(row(y), m_width, [&](int start, int end) {
+            const int x0 = qMax(rect.left(), area.left() + start * moduleSize);
+            const int x1 = qMin(rect.right() + 1, area.left() + end * moduleSize);
+            if (x1 > x0) {
+                std::fill(line + x0, line + x1, static_cast<quint32>(color));
+            }
+        });
+
+        // 同一行模块的其余扫描线直接复制
+        const uchar *source = image->constScanLine(top) + rect.left() * 4;
+        for (int i = top + 1; i < bottom; ++i) {
+            memcpy(image->scanLine(i) + rect.left() * 4, source, bytes);
+        }
+    }
+}
+
+QPainterPath QRCodeMatrix::toPath(const QRectF &area) const
+{
+    QPainterPath path;
+    if (!isValid() || area.width() <= 0 || area.height() <= 0) {
+        return path;
+    }
+
+    // 相邻矩形共用边，按非零规则填充时中间不会出现缝隙
+    path.setFillRule(Qt::WindingFill);
+
+    // 边界按模块序号计算，相邻行和相邻矩形的坐标完全相同
+    const qreal left = area.left();
+    const qreal top = area.top();
+    const qreal scaleX = area.width() / m_width;
+    const qreal scaleY = area.height() / m_width;
+
+    for (int y = 0; y < m_width; ++y) {
+        const qreal y0 = top + y * scaleY;
+        const qreal y1 = top + (y + 1) * scaleY;
+        forEachRun(row(y), m_width, [&](int start, int end) {
+            path.addRect(QRectF(QPointF(left + start * scaleX, y0), QPointF(left + end * scaleX, y1)));
+        });
+    }
+
+    return path;
+}
@@ -0,0 +1,131 @@
+#ifndef QRCODEMATRIX_H
+#define QRCODEMATRIX_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QRect>
+#include <QString>
+
+class QPainterPath;
+enum class QRErrorCorrectionLevel;
+
+/**
+ * @brief 已编码的二维码模块矩阵
+ *
+ * 数据编码、Reed-Solomon纠错和掩码选择只做一次，
+ * 之后改变颜色、尺寸或边距只需重新绘制。
+ * 值类型（隐式共享），可以在线程之间复制。
+ */
+class QRCodeMatrix
+{
+public:
+    /**
+     * @brief 构造无效的矩阵
+     */
+    QRCodeMatrix();
+
+    /**
+     * @brief 构造函数
+     * @param width 每边的模块数
+     * @param modules 按行存储的模块，每个模块一个字节，非0为深色
+     */
+    QRCodeMatrix(int width, const QByteArray &modules);
+
+    /**
+     * @brief 编码二维码
+     *
+     * 结果保存在全局缓存中，相同数据和纠错级别再次编码时直接返回，
+     * 多个元素和批量记录共用
+     *
+     * @param data 二维码数据
+     * @param level 错误校正级别
+     * @return 矩阵，无法编码时无效
+     */
+    static QRCodeMatrix encode(const QString &data, QRErrorCorrectionLevel level);
+
+    /**
+     * @brief 是否有效
+     * @return 是否包含模块
+     */
+    bool isValid() const;
+
+    /**
+     * @brief 获取每边的模块数（不含静区）
+     * @return 模块数
+     */
+    int width() const;
+
+    /**
+     * @brief 判断模块是否为深色
+     * @param x 列
+     * @param y 行
+     * @return 是否为深色
+     */
+    bool isDark(int x, int y) const;
+
+    /**
+     * @brief 获取一行模块
+     * @param y 行
+     * @return 该行width()个字节，非0为深色
+     */
+    const uchar *row(int y) const;
+
+    /**
+     * @brief 获取模块数据
+     * @return 按行存储的模块
+     */
+    QByteArray modules() const;
+
+    /**
+     * @brief 计算整数模块尺寸
+     *
+     * 模块取整数个像素（打印点），避免小数模块在打印时边缘模糊，
+     * 剩余的像素留给调用方居中
+     *
+     * @param pixels 可用的边长（像素）
+     * @param border 两侧各保留的静区模块数
+     * @return 每个模块的像素数，至少为1
+     */
+    int moduleSize(int pixels, int border = 0) const;
+
+    /**
+     * @brief 生成图像
+     *
+     * 每行模块只展开一次，其余像素行直接复制。纯函数，可以在工作线程中调用
+     *
+     * @param moduleSize 每个模块的像素数
+     * @param border 四周的静区模块数
+     * @param format Format_Mono或Format_Indexed8，颜色索引0为浅色、1为深色
+     * @return 图像，参数无效时为空
+     */
+    QImage toImage(int moduleSize, int border = 0, QImage::Format format = QImage::Format_Mono) const;
+
+    /**
+     * @brief 光栅化到32位图像
+     *
+     * 只写深色模块，每行模块的其余扫描线复制第一条，超出图像的部分被裁剪
+     *
+     * @param image 32位目标图像
+     * @param origin 第一个模块左上角的位置（像素）
+     * @param moduleSize 每个模块的像素数
+     * @param color 深色模块的颜色
+     */
+    void rasterize(QImage *image, const QPoint &origin, int moduleSize, QRgb color) const;
+
+    /**
+     * @brief 生成矢量路径
+     *
+     * 每行相邻的深色模块合并为一个矩形，整个符号一次填充。
+     * 用于PDF导出和打印，任意分辨率下边缘都精确
+     *
+     * @param area 模块区域（不含静区），可以不是正方形
+     * @return 路径，矩阵无效时为空
+     */
+    QPainterPath toPath(const QRectF &area) const;
+
+private:
+    int m_width;            ///< 每边的模块数
+    QByteArray m_modules;   ///< 按行存储的模块
+};
+
+#endif // QRCODEMATRIX_H
@@ -0,0 +1,33 @@
+#include "qrcodematrixcache.h"
+#include "qrcodeitem.h"
+
+// 默认容量：约5000个版本10（57x57）的矩阵
+static const int DEFAULT_CAPACITY = 16 * 1024 * 1024;
+
+QRCodeMatrixCache *QRCodeMatrixCache::instance()
+{
+    static QRCodeMatrixCache cache;
+    return &cache;
+}
+
+QRCodeMatrixCache::QRCodeMatrixCache()
+    : SymbolCache(DEFAULT_CAPACITY)
+{
+}
+
+bool QRCodeMatrixCache::find(const QString &data, QRErrorCorrectionLevel level, QRCodeMatrix *matrix)
+{
+    return SymbolCache::find(cacheKey(data, level), matrix);
+}
+
+void QRCodeMatrixCache::insert(const QString &data, QRErrorCorrectionLevel level, const QRCodeMatrix &matrix)
+{
+    // 编码失败的结果也占一个单位
+    SymbolCache::insert(cacheKey(data, level), matrix, matrix.width() * matrix.width());
+}
+
+QString QRCodeMatrixCache::cacheKey(const QString &data, QRErrorCorrectionLevel level)
+{
+    // 纠错级别字符后接原始数据，不会产生歧义
+    return QString(QLatin1Char(QRCodeItem::getErrorCorrectionLevelChar(level))) + data;
+}
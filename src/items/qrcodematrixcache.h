@@ -0,0 +1,55 @@
+#ifndef QRCODEMATRIXCACHE_H
+#define QRCODEMATRIXCACHE_H
+
+#include <QString>
+
+#include "qrcodematrix.h"
+#include "symbolcache.h"
+
+/**
+ * @brief 二维码矩阵缓存
+ *
+ * 进程内共享、线程安全的LRU缓存，以（数据、纠错级别）为键保存编码后的模块矩阵。
+ * 修改颜色、尺寸、边距或克隆元素只需重新绘制，不必重新编码；
+ * 批量打印中重复的数据也只编码一次。
+ * 容量按模块数计算，大版本的矩阵占用更多容量。
+ */
+class QRCodeMatrixCache : public SymbolCache<QString, QRCodeMatrix>
+{
+public:
+    /**
+     * @brief 获取全局实例
+     * @return 缓存实例
+     */
+    static QRCodeMatrixCache *instance();
+
+    /**
+     * @brief 查找矩阵
+     * @param data 二维码数据
+     * @param level 错误校正级别
+     * @param matrix 输出矩阵
+     * @return 是否命中
+     */
+    bool find(const QString &data, QRErrorCorrectionLevel level, QRCodeMatrix *matrix);
+
+    /**
+     * @brief 插入矩阵，超出容量时淘汰最久未使用的项
+     * @param data 二维码数据
+     * @param level 错误校正级别
+     * @param matrix 矩阵（编码失败时无效）
+     */
+    void insert(const QString &data, QRErrorCorrectionLevel level, const QRCodeMatrix &matrix);
+
+private:
+    QRCodeMatrixCache();
+
+    /**
+     * @brief 生成缓存键
+     * @param data 二维码数据
+     * @param level 错误校正级别
+     * @return 缓存键
+     */
+    static QString cacheKey(const QString &data, QRErrorCorrectionLevel level);
+};
+
+#endif // QRCODEMATRIXCACHE_H
@@ -0,0 +1,777 @@
+#include "qrencoder.h"
+#include "qrcodeitem.h"
+
+#include <QtAlgorithms>
+
+#include <array>
+#include <cstdlib>
+#include <cstring>
+
+// 惩罚分权重（与QRencode相同）
+static const int PENALTY_N1 = 3;
+static const int PENALTY_N2 = 3;
+static const int PENALTY_N3 = 40;
+static const int PENALTY_N4 = 10;
+
+// 每块纠错码字数，按错误校正级别（L、M、Q、H）和版本索引
+static constexpr qint8 eccCodewordsPerBlock[4][QREncoder::MAX_VERSION + 1] = {
+    {-1, 7, 10, 15, 20, 26, 18, 20, 24, 30, 18, 20, 24, 26, 30, 22, 24, 28, 30, 28, 28,
+     28, 28, 30, 30, 26, 28, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30},
+    {-1, 10, 16, 26, 18, 24, 16, 18, 22, 22, 26, 30, 22, 22, 24, 24, 28, 28, 26, 26, 26,
+     26, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28},
+    {-1, 13, 22, 18, 26, 18, 24, 18, 22, 20, 24, 28, 26, 24, 20, 30, 24, 28, 28, 26, 30,
+     28, 30, 30, 30, 30, 28, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30},
+    {-1, 17, 28, 22, 16, 22, 28, 26, 26, 24, 28, 24, 28, 22, 24, 24, 30, 28, 28, 26, 28,
+     30, 24, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30}
+};
+
+// 纠错块数，按错误校正级别和版本索引
+static constexpr qint8 eccBlockCount[4][QREncoder::MAX_VERSION + 1] = {
+    {-1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 4, 4, 4, 4, 4, 6, 6, 6, 6, 7, 8,
+     8, 9, 9, 10, 12, 12, 12, 13, 14, 15, 16, 17, 18, 19, 19, 20, 21, 22, 24, 25},
+    {-1, 1, 1, 1, 2, 2, 4, 4, 4, 5, 5, 5, 8, 9, 9, 10, 10, 11, 13, 14, 16,
+     17, 17, 18, 20, 21, 23, 25, 26, 28, 29, 31, 33, 35, 37, 38, 40, 43, 45, 47, 49},
+    {-1, 1, 1, 2, 2, 4, 4, 6, 6, 8, 8, 8, 10, 12, 16, 12, 17, 16, 18, 21, 20,
+     23, 23, 25, 27, 29, 34, 34, 35, 38, 40, 43, 45, 48, 51, 53, 56, 59, 62, 65, 68},
+    {-1, 1, 1, 2, 4, 4, 4, 5, 6, 8, 8, 11, 11, 16, 16, 18, 16, 19, 21, 25, 25,
+     25, 34, 30, 32, 35, 37, 40, 42, 45, 48, 51, 54, 57, 60, 63, 66, 70, 74, 77, 81}
+};
+
+// 格式信息中的错误校正级别位（L=01、M=00、Q=11、H=10）
+static const int formatLevelBits[4] = {1, 0, 3, 2};
+
+// 字母数字模式的字符值，-1表示不属于字符集
+static constexpr std::array<qint8, 128> makeAlphanumericValues()
+{
+    std::array<qint8, 128> values = {};
+    for (int i = 0; i < 128; ++i) {
+        values[i] = -1;
+    }
+
+    const char charset[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ $%*+-./:";
+    for (int i = 0; charset[i] != '\0'; ++i) {
+        values[static_cast<unsigned char>(charset[i])] = static_cast<qint8>(i);
+    }
+    return values;
+}
+
+static constexpr std::array<qint8, 128> alphanumericValues = makeAlphanumericValues();
+
+/**
+ * @brief GF(256)的指数和对数表（本原多项式0x11D）
+ *
+ * 指数表长度为512，两个对数相加后不必取模
+ */
+struct GaloisField
+{
+    std::array<uchar, 512> exp = {};
+    std::array<uchar, 256> log = {};
+};
+
+static constexpr GaloisField makeGaloisField()
+{
+    GaloisField field;
+    int x = 1;
+    for (int i = 0; i < 255; ++i) {
+        field.exp[i] = static_cast<uchar>(x);
+        field.log[x] = static_cast<uchar>(i);
+        x <<= 1;
+        if (x & 0x100) {
+            x ^= 0x11D;
+        }
+    }
+    for (int i = 255; i < 512; ++i) {
+        field.exp[i] = field.exp[i - 255];
+    }
+    return field;
+}
+
+static constexpr GaloisField gf = makeGaloisField();
+
+static constexpr uchar gfMultiply(uchar a, uchar b)
+{
+    return (a == 0 || b == 0) ? 0 : gf.exp[gf.log[a] + gf.log[b]];
+}
+
+/**
+ * @brief 各阶生成多项式的系数（去掉首项1，从高次到常数项，以对数表示）
+ */
+struct GeneratorTable
+{
+    std::array<std::array<uchar, QREncoder::MAX_ECC>, QREncoder::MAX_ECC + 1> logs = {};
+};
+
+static constexpr GeneratorTable makeGeneratorTable()
+{
+    GeneratorTable table;
+    for (int degree = 1; degree <= QREncoder::MAX_ECC; ++degree) {
+        // 依次乘以(x - α^i)，i从0到degree-1
+        std::array<uchar, QREncoder::MAX_ECC> poly = {};
+        poly[degree - 1] = 1;
+        uchar root = 1;
+        for (int i = 0; i < degree; ++i) {
+            for (int j = 0; j < degree; ++j) {
+                poly[j] = gfMultiply(poly[j], root);
+                if (j + 1 < degree) {
+                    poly[j] ^= poly[j + 1];
+                }
+            }
+            root = gfMultiply(root, 2);
+        }
+        for (int j = 0; j < degree; ++j) {
+            table.logs[degree][j] = gf.log[poly[j]];
+        }
+    }
+    return table;
+}
+
+static constexpr GeneratorTable generators = makeGeneratorTable();
+
+// 计算一块数据的纠错码字
+static void reedSolomon(const uchar *data, int dataLength, int eccLength, uchar *ecc)
+{
+    const uchar *generator = generators.logs[eccLength].data();
+    memset(ecc, 0, eccLength);
+
+    for (int i = 0; i < dataLength; ++i) {
+        const uchar factor = data[i] ^ ecc[0];
+        memmove(ecc, ecc + 1, eccLength - 1);
+        ecc[eccLength - 1] = 0;
+
+        if (factor != 0) {
+            const int logFactor = gf.log[factor];
+            for (int j = 0; j < eccLength; ++j) {
+                ecc[j] ^= gf.exp[generator[j] + logFactor];
+            }
+        }
+    }
+}
+
+// 除功能图形外可放置数据的模块数
+static int rawDataModules(int version)
+{
+    int result = (16 * version + 128) * version + 64;
+    if (version >= 2) {
+        const int alignCount = version / 7 + 2;
+        result -= (25 * alignCount - 10) * alignCount - 55;
+        if (version >= 7) {
+            result -= 36;
+        }
+    }
+    return result;
+}
+
+// 校正图形的中心坐标
+static int alignmentPositions(int version, int *positions)
+{
+    if (version == 1) {
+        return 0;
+    }
+
+    const int count = version / 7 + 2;
+    const int width = version * 4 + 17;
+    const int step = version == 32 ? 26 : (version * 4 + count * 2 + 1) / (count * 2 - 2) * 2;
+
+    positions[0] = 6;
+    for (int i = count - 1, pos = width - 7; i >= 1; --i, pos -= step) {
+        positions[i] = pos;
+    }
+    return count;
+}
+
+// 格式信息第bit位的两个位置
+static void formatPositions(int width, int bit, int *x1, int *y1, int *x2, int *y2)
+{
+    if (bit < 6) {
+        *x1 = 8;
+        *y1 = bit;
+    } else if (bit < 8) {
+        *x1 = 8;
+        *y1 = bit + 1;
+    } else if (bit == 8) {
+        *x1 = 7;
+        *y1 = 8;
+    } else {
+        *x1 = 14 - bit;
+        *y1 = 8;
+    }
+
+    if (bit < 8) {
+        *x2 = width - 1 - bit;
+        *y2 = 8;
+    } else {
+        *x2 = 8;
+        *y2 = width - 15 + bit;
+    }
+}
+
+// 格式信息（BCH(15,5)编码后与0x5412异或）
+static int formatBits(int ecl, int mask)
+{
+    const int data = formatLevelBits[ecl] << 3 | mask;
+    int remainder = data;
+    for (int i = 0; i < 10; ++i) {
+        remainder = (remainder << 1) ^ ((remainder >> 9) * 0x537);
+    }
+    return ((data << 10) | (remainder & 0x3FF)) ^ 0x5412;
+}
+
+// 版本信息（BCH(18,6)编码）
+static int versionBits(int version)
+{
+    int remainder = version;
+    for (int i = 0; i < 12; ++i) {
+        remainder = (remainder << 1) ^ ((remainder >> 11) * 0x1F25);
+    }
+    return version << 12 | (remainder & 0xFFF);
+}
+
+// 编码模式指示符
+static int modeIndicator(QRSegmentOptimizer::Mode mode)
+{
+    switch (mode) {
+        case QRSegmentOptimizer::NumericMode:
+            return 0x1;
+        case QRSegmentOptimizer::AlphanumericMode:
+            return 0x2;
+        case QRSegmentOptimizer::KanjiMode:
+            return 0x8;
+        default:
+            return 0x4;
+    }
+}
+
+// 段的字符数（汉字每个字符两个字节）
+static int characterCount(const QRSegmentOptimizer::Segment &segment)
+{
+    return segment.mode == QRSegmentOptimizer::KanjiMode ? segment.data.size() / 2 : segment.data.size();
+}
+
+// 若干字符的数据位数（不含段头）
+static int dataBits(QRSegmentOptimizer::Mode mode, int count)
+{
+    switch (mode) {
+        case QRSegmentOptimizer::NumericMode:
+            return count / 3 * 10 + (count % 3 == 2 ? 7 : (count % 3 == 1 ? 4 : 0));
+        case QRSegmentOptimizer::AlphanumericMode:
+            return count / 2 * 11 + (count % 2) * 6;
+        case QRSegmentOptimizer::KanjiMode:
+            return count * 13;
+        default:
+            return count * 8;
+    }
+}
+
+/**
+ * @brief 掩码图案
+ *
+ * 所有掩码在行方向以12为周期、在列方向以6为周期，
+ * 预先按位展开，应用掩码时整字异或
+ */
+struct MaskPatterns
+{
+    quint64 rows[8][12][QREncoder::ROW_WORDS];  ///< 第y%12行，位x为(x, y)
+    quint64 cols[8][12][QREncoder::ROW_WORDS];  ///< 第x%12列，位y为(x, y)
+
+    MaskPatterns()
+    {
+        memset(rows, 0, sizeof(rows));
+        memset(cols, 0, sizeof(cols));
+
+        for (int mask = 0; mask < 8; ++mask) {
+            for (int phase = 0; phase < 12; ++phase) {
+                for (int i = 0; i < QREncoder::ROW_WORDS * 64; ++i) {
+                    if (isMasked(mask, i, phase)) {
+                        rows[mask][phase][i >> 6] |= Q_UINT64_C(1) << (i & 63);
+                    }
+                    if (isMasked(mask, phase, i)) {
+                        cols[mask][phase][i >> 6] |= Q_UINT64_C(1) << (i & 63);
+                    }
+                }
+            }
+        }
+    }
+
+    static bool isMasked(int mask, int x, int y)
+    {
+        switch (mask) {
+            case 0: return ((x + y) & 1) == 0;
+            case 1: return (y & 1) == 0;
+            case 2: return x % 3 == 0;
+            case 3: return (x + y) % 3 == 0;
+            case 4: return (((y / 2) + (x / 3)) & 1) == 0;
+            case 5: return ((x * y) & 1) + (x * y) % 3 == 0;
+            case 6: return ((((x * y) & 1) + (x * y) % 3) & 1) == 0;
+            default: return ((((x * y) % 3) + ((x + y) & 1)) & 1) == 0;
+        }
+    }
+};
+
+static const MaskPatterns &maskPatterns()
+{
+    static const MaskPatterns patterns;
+    return patterns;
+}
+
+// 位集左移一位（位x移到位x+1）
+static inline void shiftLeft(const quint64 *bits, quint64 *result)
+{
+    quint64 carry = 0;
+    for (int k = 0; k < QREncoder::ROW_WORDS; ++k) {
+        result[k] = (bits[k] << 1) | carry;
+        carry = bits[k] >> 63;
+    }
+}
+
+QREncoder::QREncoder()
+    : m_width(0)
+    , m_bitCount(0)
+{
+}
+
+int QREncoder::dataCodewords(int version, int ecl)
+{
+    return rawDataModules(version) / 8 - eccCodewordsPerBlock[ecl][version] * eccBlockCount[ecl][version];
+}
+
+int QREncoder::bitLength(const QVector<QRSegmentOptimizer::Segment> &segments, int version)
+{
+    int bits = 0;
+    for (const QRSegmentOptimizer::Segment &segment : segments) {
+        const int countBits = QRSegmentOptimizer::characterCountBits(segment.mode, version);
+        const int maxCount = (1 << countBits) - 1;
+        int count = characterCount(segment);
+
+        // 超过字符计数上限的段拆分为多个段
+        while (count > 0) {
+            const int chunk = qMin(count, maxCount);
+            bits += 4 + countBits + dataBits(segment.mode, chunk);
+            count -= chunk;
+        }
+    }
+    return bits;
+}
+
+int QREncoder::encode(const QVector<QRSegmentOptimizer::Segment> &segments, QRErrorCorrectionLevel level,
+                      QRCodeMatrix *matrix)
+{
+    if (segments.isEmpty() || !matrix) {
+        return 0;
+    }
+
+    const int ecl = qBound(0, static_cast<int>(level), 3);
+
+    // 能容纳数据的最小版本
+    int version = 1;
+    while (version <= MAX_VERSION && bitLength(segments, version) > dataCodewords(version, ecl) * 8) {
+        ++version;
+    }
+    if (version > MAX_VERSION) {
+        return 0;
+    }
+
+    writeData(segments, version, dataCodewords(version, ecl));
+    const int codewords = interleave(version, ecl);
+    drawSymbol(version, codewords);
+    buildBitsets();
+
+    // 选择惩罚分最低的掩码，相同时取序号小的
+    int bestMask = 0;
+    int bestPenalty = 0;
+    for (int mask = 0; mask < 8; ++mask) {
+        applyMask(mask, ecl);
+        const int score = penalty();
+        if (mask == 0 || score < bestPenalty) {
+            bestMask = mask;
+            bestPenalty = score;
+        }
+    }
+
+    // 输出最佳掩码的结果
+    applyMask(bestMask, ecl);
+    QByteArray modules(m_width * m_width, Qt::Uninitialized);
+    char *out = modules.data();
+    for (int y = 0; y < m_width; ++y) {
+        for (int x = 0; x < m_width; ++x) {
+            *out++ = static_cast<char>((m_rows[y][x >> 6] >> (x & 63)) & 1);
+        }
+    }
+
+    *matrix = QRCodeMatrix(m_width, modules);
+    return version;
+}
+
+void QREncoder::writeBits(int value, int count)
+{
+    for (int i = count - 1; i >= 0; --i) {
+        if ((value >> i) & 1) {
+            m_data[m_bitCount >> 3] |= static_cast<uchar>(0x80 >> (m_bitCount & 7));
+        }
+        ++m_bitCount;
+    }
+}
+
+void QREncoder::writeData(const QVector<QRSegmentOptimizer::Segment> &segments, int version, int capacity)
+{
+    memset(m_data, 0, capacity);
+    m_bitCount = 0;
+
+    for (const QRSegmentOptimizer::Segment &segment : segments) {
+        const int countBits = QRSegmentOptimizer::characterCountBits(segment.mode, version);
+        const int maxCount = (1 << countBits) - 1;
+        const int unitBytes = segment.mode == QRSegmentOptimizer::KanjiMode ? 2 : 1;
+        const uchar *data = reinterpret_cast<const uchar*>(segment.data.constData());
+        int remaining = characterCount(segment);
+
+        while (remaining > 0) {
+            const int count = qMin(remaining, maxCount);
+            writeBits(modeIndicator(segment.mode), 4);
+            writeBits(count, countBits);
+
+            switch (segment.mode) {
+                case QRSegmentOptimizer::NumericMode:
+                    for (int i = 0; i < count; i += 3) {
+                        const int digits = qMin(3, count - i);
+                        int value = 0;
+                        for (int j = 0; j < digits; ++j) {
+                            value = value * 10 + (data[i + j] - '0');
+                        }
+                        writeBits(value, digits * 3 + 1);
+                    }
+                    break;
+                case QRSegmentOptimizer::AlphanumericMode:
+                    for (int i = 0; i < count; i += 2) {
+                        if (i + 1 < count) {
+                            writeBits(alphanumericValues[data[i]] * 45 + alphanumericValues[data[i + 1]], 11);
+                        } else {
+                            writeBits(alphanumericValues[data[i]], 6);
+                        }
+                    }
+                    break;
+                case QRSegmentOptimizer::KanjiMode:
+                    for (int i = 0; i < count; ++i) {
+                        int code = (data[i * 2] << 8) | data[i * 2 + 1];
+                        code -= code <= 0x9FFC ? 0x8140 : 0xC140;
+                        writeBits((code >> 8) * 0xC0 + (code & 0xFF), 13);
+                    }
+                    break;
+                default:
+                    for (int i = 0; i < count; ++i) {
+                        writeBits(data[i], 8);
+                    }
+                    break;
+            }
+
+            data += count * unitBytes;
+            remaining -= count;
+        }
+    }
+
+    // 终止符最多4位，再补齐到整字节，剩余码字交替填充0xEC、0x11
+    const int capacityBits = capacity * 8;
+    m_bitCount = qMin(capacityBits, m_bitCount + 4);
+    m_bitCount = (m_bitCount + 7) / 8 * 8;
+    for (int i = m_bitCount / 8, pad = 0; i < capacity; ++i, pad ^= 1) {
+        m_data[i] = pad ? 0x11 : 0xEC;
+    }
+}
+
+int QREncoder::interleave(int version, int ecl)
+{
+    const int blocks = eccBlockCount[ecl][version];
+    const int eccLength = eccCodewordsPerBlock[ecl][version];
+    const int total = rawDataModules(version) / 8;
+
+    // 前shortBlocks块的数据码字比后面的块少1个
+    const int shortBlocks = blocks - total % blocks;
+    const int shortData = total / blocks - eccLength;
+
+    int offset = 0;
+    for (int b = 0; b < blocks; ++b) {
+        const int length = shortData + (b >= shortBlocks ? 1 : 0);
+        reedSolomon(m_data + offset, length, eccLength, m_ecc + b * eccLength);
+        offset += length;
+    }
+
+    // 按列交织：先数据码字，再纠错码字
+    int out = 0;
+    for (int i = 0; i <= shortData; ++i) {
+        for (int b = 0, blockOffset = 0; b < blocks; ++b) {
+            const int length = shortData + (b >= shortBlocks ? 1 : 0);
+            if (i < length) {
+                m_codewords[out++] = m_data[blockOffset + i];
+            }
+            blockOffset += length;
+        }
+    }
+    for (int i = 0; i < eccLength; ++i) {
+        for (int b = 0; b < blocks; ++b) {
+            m_codewords[out++] = m_ecc[b * eccLength + i];
+        }
+    }
+
+    return out;
+}
+
+void QREncoder::setFunction(int x, int y, bool dark)
+{
+    m_frame[y * m_width + x] = dark ? 0x81 : 0x80;
+}
+
+void QREncoder::drawSymbol(int version, int codewords)
+{
+    m_width = version * 4 + 17;
+    const int width = m_width;
+    memset(m_frame, 0, static_cast<size_t>(width) * width);
+
+    // 时序图形
+    for (int i = 0; i < width; ++i) {
+        setFunction(6, i, i % 2 == 0);
+        setFunction(i, 6, i % 2 == 0);
+    }
+
+    // 定位图形和分隔符
+    const int finderCenters[3][2] = {{3, 3}, {width - 4, 3}, {3, width - 4}};
+    for (const auto &center : finderCenters) {
+        for (int dy = -4; dy <= 4; ++dy) {
+            for (int dx = -4; dx <= 4; ++dx) {
+                const int x = center[0] + dx;
+                const int y = center[1] + dy;
+                if (x >= 0 && x < width && y >= 0 && y < width) {
+                    const int distance = qMax(qAbs(dx), qAbs(dy));
+                    setFunction(x, y, distance != 2 && distance != 4);
+                }
+            }
+        }
+    }
+
+    // 校正图形（跳过与定位图形重叠的三个角）
+    int positions[7];
+    const int alignCount = alignmentPositions(version, positions);
+    for (int i = 0; i < alignCount; ++i) {
+        for (int j = 0; j < alignCount; ++j) {
+            if ((i == 0 && j == 0) || (i == 0 && j == alignCount - 1) || (i == alignCount - 1 && j == 0)) {
+                continue;
+            }
+            for (int dy = -2; dy <= 2; ++dy) {
+                for (int dx = -2; dx <= 2; ++dx) {
+                    setFunction(positions[i] + dx, positions[j] + dy, qMax(qAbs(dx), qAbs(dy)) != 1);
+                }
+            }
+        }
+    }
+
+    // 格式信息区域先保留为浅色，应用掩码时写入
+    for (int bit = 0; bit < 15; ++bit) {
+        int x1, y1, x2, y2;
+        formatPositions(width, bit, &x1, &y1, &x2, &y2);
+        setFunction(x1, y1, false);
+        setFunction(x2, y2, false);
+    }
+    setFunction(8, width - 8, true);
+
+    // 版本信息
+    if (version >= 7) {
+        const int bits = versionBits(version);
+        for (int i = 0; i < 18; ++i) {
+            const bool dark = (bits >> i) & 1;
+            const int a = width - 11 + i % 3;
+            const int b = i / 3;
+            setFunction(a, b, dark);
+            setFunction(b, a, dark);
+        }
+    }
+
+    // 从右下角开始，两列一组上下交替放置码字，跳过时序图形所在的列
+    const int totalBits = codewords * 8;
+    int bit = 0;
+    for (int right = width - 1; right >= 1; right -= 2) {
+        if (right == 6) {
+            right = 5;
+        }
+        const bool upward = ((right + 1) & 2) == 0;
+        for (int vert = 0; vert < width; ++vert) {
+            const int y = upward ? width - 1 - vert : vert;
+            for (int j = 0; j < 2; ++j) {
+                uchar &module = m_frame[y * width + right - j];
+                if (module & 0x80) {
+                    continue;
+                }
+                // 剩余位为浅色
+                if (bit < totalBits) {
+                    module = (m_codewords[bit >> 3] >> (7 - (bit & 7))) & 1;
+                    ++bit;
+                }
+            }
+        }
+    }
+}
+
+void QREncoder::buildBitsets()
+{
+    const int width = m_width;
+    memset(m_baseRows, 0, sizeof(m_baseRows));
+    memset(m_baseCols, 0, sizeof(m_baseCols));
+
+    // 边长以外的位视为功能模块，不受掩码影响
+    quint64 outside[ROW_WORDS];
+    for (int k = 0; k < ROW_WORDS; ++k) {
+        const int from = qBound(0, width - k * 64, 64);
+        outside[k] = from >= 64 ? 0 : ~Q_UINT64_C(0) << from;
+    }
+    for (int i = 0; i < MAX_WIDTH; ++i) {
+        memcpy(m_functionRows[i], outside, sizeof(outside));
+        memcpy(m_functionCols[i], outside, sizeof(outside));
+    }
+
+    for (int y = 0; y < width; ++y) {
+        const uchar *row = m_frame + y * width;
+        for (int x = 0; x < width; ++x) {
+            const uchar module = row[x];
+            if (module & 0x01) {
+                m_baseRows[y][x >> 6] |= Q_UINT64_C(1) << (x & 63);
+                m_baseCols[x][y >> 6] |= Q_UINT64_C(1) << (y & 63);
+            }
+            if (module & 0x80) {
+                m_functionRows[y][x >> 6] |= Q_UINT64_C(1) << (x & 63);
+                m_functionCols[x][y >> 6] |= Q_UINT64_C(1) << (y & 63);
+            }
+        }
+    }
+}
+
+void QREncoder::applyMask(int mask, int ecl)
+{
+    const MaskPatterns &patterns = maskPatterns();
+    const int width = m_width;
+
+    for (int i = 0; i < width; ++i) {
+        const quint64 *rowPattern = patterns.rows[mask][i % 12];
+        const quint64 *colPattern = patterns.cols[mask][i % 12];
+        for (int k = 0; k < ROW_WORDS; ++k) {
+            m_rows[i][k] = m_baseRows[i][k] ^ (rowPattern[k] & ~m_functionRows[i][k]);
+            m_cols[i][k] = m_baseCols[i][k] ^ (colPattern[k] & ~m_functionCols[i][k]);
+        }
+    }
+
+    // 格式信息（两份）
+    const int bits = formatBits(ecl, mask);
+    for (int bit = 0; bit < 15; ++bit) {
+        if (!((bits >> bit) & 1)) {
+            continue;
+        }
+        int x[2], y[2];
+        formatPositions(width, bit, &x[0], &y[0], &x[1], &y[1]);
+        for (int i = 0; i < 2; ++i) {
+            m_rows[y[i]][x[i] >> 6] |= Q_UINT64_C(1) << (x[i] & 63);
+            m_cols[x[i]][y[i] >> 6] |= Q_UINT64_C(1) << (y[i] & 63);
+        }
+    }
+}
+
+int QREncoder::runLengths(const quint64 *bits)
+{
+    const int width = m_width;
+    int head = 0;
+
+    // 以深色开头时第一个游程记为-1，浅色游程总在偶数位置
+    if (bits[0] & 1) {
+        m_runs[0] = -1;
+        head = 1;
+    }
+
+    int pos = 0;
+    while (pos < width) {
+        const bool dark = (bits[pos >> 6] >> (pos & 63)) & 1;
+        const quint64 invert = dark ? ~Q_UINT64_C(0) : 0;
+
+        // 找到下一个颜色不同的位
+        int k = pos >> 6;
+        quint64 word = (bits[k] ^ invert) & (~Q_UINT64_C(0) << (pos & 63));
+        while (word == 0 && ++k < ROW_WORDS) {
+            word = bits[k] ^ invert;
+        }
+        const int next = word == 0 ? width : qMin(width, k * 64 + qCountTrailingZeroBits(word));
+
+        m_runs[head++] = next - pos;
+        pos = next;
+    }
+
+    return head;
+}
+
+int QREncoder::penaltyN1N3(int length) const
+{
+    const int *runs = m_runs;
+    int score = 0;
+
+    for (int i = 0; i < length; ++i) {
+        if (runs[i] >= 5) {
+            score += PENALTY_N1 + (runs[i] - 5);
+        }
+
+        // 深色游程为中心的1:1:3:1:1图形，一侧有4倍宽的浅色区域
+        if ((i & 1) && i >= 3 && i < length - 2 && runs[i] % 3 == 0) {
+            const int fact = runs[i] / 3;
+            if (runs[i - 2] == fact && runs[i - 1] == fact && runs[i + 1] == fact && runs[i + 2] == fact) {
+                if (i == 3 || runs[i - 3] >= 4 * fact) {
+                    score += PENALTY_N3;
+                } else if (i + 4 >= length || runs[i + 3] >= 4 * fact) {
+                    score += PENALTY_N3;
+                }
+            }
+        }
+    }
+
+    return score;
+}
+
+int QREncoder::penalty()
+{
+    const int width = m_width;
+    int score = 0;
+
+    // N4：深色比例偏离50%
+    int blacks = 0;
+    for (int y = 0; y < width; ++y) {
+        for (int k = 0; k < ROW_WORDS; ++k) {
+            blacks += qPopulationCount(m_rows[y][k]);
+        }
+    }
+    const int area = width * width;
+    const int ratio = (200 * blacks + area) / area / 2;
+    score += (std::abs(ratio - 50) / 5) * PENALTY_N4;
+
+    // N2：2x2同色块，位x表示以(x-1, y-1)为左上角的块
+    quint64 valid[ROW_WORDS];
+    for (int k = 0; k < ROW_WORDS; ++k) {
+        const int from = qBound(0, width - k * 64, 64);
+        valid[k] = from >= 64 ? ~Q_UINT64_C(0) : ~(~Q_UINT64_C(0) << from);
+    }
+    valid[0] &= ~Q_UINT64_C(1);
+
+    for (int y = 1; y < width; ++y) {
+        const quint64 *upper = m_rows[y - 1];
+        const quint64 *lower = m_rows[y];
+        quint64 upperShifted[ROW_WORDS];
+        quint64 lowerShifted[ROW_WORDS];
+        shiftLeft(upper, upperShifted);
+        shiftLeft(lower, lowerShifted);
+
+        for (int k = 0; k < ROW_WORDS; ++k) {
+            const quint64 same = ~(upper[k] ^ lower[k]) & ~(upper[k] ^ upperShifted[k])
+                               & ~(lower[k] ^ lowerShifted[k]);
+            score += qPopulationCount(same & valid[k]) * PENALTY_N2;
+        }
+    }
+
+    // N1、N3：逐行、逐列
+    for (int i = 0; i < width; ++i) {
+        score += penaltyN1N3(runLengths(m_rows[i]));
+    }
+    for (int i = 0; i < width; ++i) {
+        score += penaltyN1N3(runLengths(m_cols[i]));
+    }
+
+    return score;
+}
@@ -0,0 +1,150 @@
+#ifndef QRENCODER_H
+#define QRENCODER_H
+
+#include <QVector>
+
+#include "qrcodematrix.h"
+#include "qrsegmentoptimizer.h"
+
+/**
+ * @brief 内置二维码编码器
+ *
+ * 与QRencode库逐位一致（相同的分段、版本选择、填充、Reed-Solomon纠错和掩码评分），
+ * 用于批量打印序列号二维码：
+ * - GF(256)的对数/反对数表和生成多项式在编译期计算
+ * - 工作区是固定大小的成员数组，编码过程中不分配内存
+ * - 掩码评分按64位字处理整行和整列，8个掩码只需按位异或
+ *
+ * 对象较大（约70KB），每个线程保留一个实例重复使用，不能在线程之间共享。
+ */
+class QREncoder
+{
+public:
+    static const int MAX_VERSION = 40;      ///< 最大版本
+    static const int MAX_WIDTH = 177;       ///< 最大边长（模块）
+    static const int MAX_CODEWORDS = 3706;  ///< 最大码字数
+    static const int MAX_BLOCKS = 81;       ///< 最大纠错块数
+    static const int MAX_ECC = 30;          ///< 每块最大纠错码字数
+    static const int ROW_WORDS = 3;         ///< 每行（列）的64位字数
+
+    /**
+     * @brief 构造函数
+     */
+    QREncoder();
+
+    /**
+     * @brief 编码二维码
+     *
+     * 选择能容纳分段的最小版本，超过字符计数上限的段与QRencode一样拆分
+     *
+     * @param segments 分段
+     * @param level 错误校正级别
+     * @param matrix 输出矩阵
+     * @return 版本（1-40），数据为空或超出容量时返回0
+     */
+    int encode(const QVector<QRSegmentOptimizer::Segment> &segments, QRErrorCorrectionLevel level,
+               QRCodeMatrix *matrix);
+
+    /**
+     * @brief 获取数据码字数
+     * @param version 版本
+     * @param ecl 错误校正级别序号（0-3对应L、M、Q、H）
+     * @return 码字数
+     */
+    static int dataCodewords(int version, int ecl);
+
+    /**
+     * @brief 计算分段的总位数（含超长段拆分）
+     * @param segments 分段
+     * @param version 版本
+     * @return 位数
+     */
+    static int bitLength(const QVector<QRSegmentOptimizer::Segment> &segments, int version);
+
+private:
+    /**
+     * @brief 写入数据码字（含终止符和填充）
+     * @param segments 分段
+     * @param version 版本
+     * @param capacity 数据码字数
+     */
+    void writeData(const QVector<QRSegmentOptimizer::Segment> &segments, int version, int capacity);
+
+    /**
+     * @brief 写入若干位（高位在前）
+     * @param value 值
+     * @param count 位数
+     */
+    void writeBits(int value, int count);
+
+    /**
+     * @brief 分块计算纠错码并交织
+     * @param version 版本
+     * @param ecl 错误校正级别序号
+     * @return 码字总数
+     */
+    int interleave(int version, int ecl);
+
+    /**
+     * @brief 绘制功能图形并放置码字
+     * @param version 版本
+     * @param codewords 码字总数
+     */
+    void drawSymbol(int version, int codewords);
+
+    /**
+     * @brief 设置功能模块
+     * @param x 列
+     * @param y 行
+     * @param dark 是否为深色
+     */
+    void setFunction(int x, int y, bool dark);
+
+    /**
+     * @brief 由模块帧生成行、列位集
+     */
+    void buildBitsets();
+
+    /**
+     * @brief 应用掩码并写入格式信息
+     * @param mask 掩码（0-7）
+     * @param ecl 错误校正级别序号
+     */
+    void applyMask(int mask, int ecl);
+
+    /**
+     * @brief 计算当前掩码结果的惩罚分
+     * @return 惩罚分
+     */
+    int penalty();
+
+    /**
+     * @brief 计算一行（列）的游程，格式与QRencode相同
+     * @param bits 位集
+     * @return 游程数
+     */
+    int runLengths(const quint64 *bits);
+
+    /**
+     * @brief 计算N1（连续同色）和N3（类定位图形）惩罚
+     * @param length 游程数
+     * @return 惩罚分
+     */
+    int penaltyN1N3(int length) const;
+
+    int m_width;                                    ///< 当前边长
+    int m_bitCount;                                 ///< 已写入的数据位数
+    uchar m_data[MAX_CODEWORDS];                    ///< 数据码字
+    uchar m_ecc[MAX_BLOCKS * MAX_ECC];              ///< 各块纠错码字
+    uchar m_codewords[MAX_CODEWORDS];               ///< 交织后的码字
+    uchar m_frame[MAX_WIDTH * MAX_WIDTH];           ///< 模块帧，位0为深色，位7为功能模块
+    quint64 m_baseRows[MAX_WIDTH][ROW_WORDS];       ///< 未加掩码的行
+    quint64 m_functionRows[MAX_WIDTH][ROW_WORDS];   ///< 功能模块的行（边长以外置1）
+    quint64 m_baseCols[MAX_WIDTH][ROW_WORDS];       ///< 未加掩码的列
+    quint64 m_functionCols[MAX_WIDTH][ROW_WORDS];   ///< 功能模块的列（边长以外置1）
+    quint64 m_rows[MAX_WIDTH][ROW_WORDS];           ///< 加掩码后的行
+    quint64 m_cols[MAX_WIDTH][ROW_WORDS];           ///< 加掩码后的列
+    int m_runs[MAX_WIDTH + 1];                      ///< 游程
+};
+
+#endif // QRENCODER_H
@@ -0,0 +1,275 @@
+#include "qrsegmentoptimizer.h"
+
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+#include <QTextCodec>
+#elif QT_VERSION >= QT_VERSION_CHECK(6, 4, 0)
+#include <QStringEncoder>
+#endif
+
+#include <array>
+#include <limits>
+
+// 模式数
+static const int MODE_COUNT = 4;
+
+// 模式指示符位数
+static const int MODE_INDICATOR_BITS = 4;
+
+// 不可达状态
+static const int UNREACHABLE = std::numeric_limits<int>::max() / 2;
+
+// 字母数字模式的字符集，下标即字符值
+static constexpr char alphanumericCharset[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ $%*+-./:";
+
+// ASCII字符是否可以用字母数字模式编码
+static constexpr std::array<bool, 128> makeAlphanumericTable()
+{
+    std::array<bool, 128> table = {};
+    for (int i = 0; alphanumericCharset[i] != '\0'; ++i) {
+        table[static_cast<unsigned char>(alphanumericCharset[i])] = true;
+    }
+    return table;
+}
+
+static constexpr std::array<bool, 128> alphanumericTable = makeAlphanumericTable();
+
+/**
+ * @brief Shift JIS转换
+ *
+ * Qt 5使用QTextCodec，Qt 6.4以上在有ICU时使用QStringEncoder，
+ * 其余情况不支持，汉字模式不会被选中
+ */
+class ShiftJisEncoder
+{
+public:
+    ShiftJisEncoder()
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+        : m_codec(QTextCodec::codecForName("Shift-JIS"))
+#elif QT_VERSION >= QT_VERSION_CHECK(6, 4, 0)
+        : m_encoder("Shift_JIS")
+#endif
+    {
+    }
+
+    bool isValid() const
+    {
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+        return m_codec != nullptr;
+#elif QT_VERSION >= QT_VERSION_CHECK(6, 4, 0)
+        return m_encoder.isValid();
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief 转换单个字符
+     * @param ch 字符
+     * @return 汉字模式可编码的两个字节，不可编码时为空
+     */
+    QByteArray encode(QChar ch)
+    {
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+        const QByteArray bytes = m_codec->fromUnicode(&ch, 1);
+#elif QT_VERSION >= QT_VERSION_CHECK(6, 4, 0)
+        const QByteArray bytes = m_encoder.encode(QStringView(&ch, 1));
+#else
+        const QByteArray bytes;
+#endif
+        if (bytes.size() != 2) {
+            return QByteArray();
+        }
+
+        // 汉字模式只能编码0x8140-0x9FFC和0xE040-0xEBBF两个区间
+        const int code = (static_cast<uchar>(bytes.at(0)) << 8) | static_cast<uchar>(bytes.at(1));
+        if ((code >= 0x8140 && code <= 0x9FFC) || (code >= 0xE040 && code <= 0xEBBF)) {
+            return bytes;
+        }
+        return QByteArray();
+    }
+
+private:
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QTextCodec *m_codec;
+#elif QT_VERSION >= QT_VERSION_CHECK(6, 4, 0)
+    QStringEncoder m_encoder;
+#endif
+};
+
+/**
+ * @brief 字符（码点）及其在各模式下的编码
+ */
+struct CharUnit
+{
+    QByteArray utf8;        ///< UTF-8字节
+    QByteArray kanji;       ///< Shift JIS字节，不可用汉字模式时为空
+    bool numeric = false;   ///< 是否为数字
+    bool alphanumeric = false; ///< 是否属于字母数字字符集
+};
+
+int QRSegmentOptimizer::characterCountBits(Mode mode, int version)
+{
+    // 版本区间：1-9、10-26、27-40
+    const int group = version <= 9 ? 0 : (version <= 26 ? 1 : 2);
+
+    static const int bits[MODE_COUNT][3] = {
+        {10, 12, 14},   // 数字
+        {9, 11, 13},    // 字母数字
+        {8, 16, 16},    // 字节
+        {8, 10, 12}     // 汉字
+    };
+    return bits[mode][group];
+}
+
+QVector<QRSegmentOptimizer::Segment> QRSegmentOptimizer::optimize(const QString &data, int version, bool allowKanji)
+{
+    QVector<Segment> segments;
+    if (data.isEmpty()) {
+        return segments;
+    }
+
+    ShiftJisEncoder shiftJis;
+    const bool kanji = allowKanji && shiftJis.isValid();
+
+    // 按码点拆分字符，代理对作为一个字符
+    QVector<CharUnit> units;
+    units.reserve(data.size());
+    for (int i = 0; i < data.size(); ++i) {
+        CharUnit unit;
+        const QChar ch = data.at(i);
+        const ushort code = ch.unicode();
+
+        if (ch.isHighSurrogate() && i + 1 < data.size() && data.at(i + 1).isLowSurrogate()) {
+            unit.utf8 = data.mid(i, 2).toUtf8();
+            ++i;
+        } else if (code < 0x80) {
+            unit.utf8 = QByteArray(1, static_cast<char>(code));
+            unit.numeric = code >= '0' && code <= '9';
+            unit.alphanumeric = alphanumericTable[code];
+        } else {
+            unit.utf8 = QString(ch).toUtf8();
+            if (kanji) {
+                unit.kanji = shiftJis.encode(ch);
+            }
+        }
+
+        units.append(unit);
+    }
+
+    // 各模式开始新段的代价：模式指示符和字符计数字段
+    int headCosts[MODE_COUNT];
+    for (int m = 0; m < MODE_COUNT; ++m) {
+        headCosts[m] = (MODE_INDICATOR_BITS + characterCountBits(static_cast<Mode>(m), version)) * 6;
+    }
+
+    // charModes[i][m]：处理完第i个字符、当前处于模式m时，第i个字符使用的模式
+    const int count = units.size();
+    QVector<std::array<qint8, MODE_COUNT>> charModes(count);
+
+    int prevCosts[MODE_COUNT];
+    for (int m = 0; m < MODE_COUNT; ++m) {
+        prevCosts[m] = headCosts[m];
+    }
+
+    for (int i = 0; i < count; ++i) {
+        const CharUnit &unit = units.at(i);
+        std::array<qint8, MODE_COUNT> &modes = charModes[i];
+        modes.fill(-1);
+
+        int curCosts[MODE_COUNT] = {UNREACHABLE, UNREACHABLE, UNREACHABLE, UNREACHABLE};
+
+        // 在当前模式中追加该字符（1/6比特为单位）
+        if (unit.numeric) {
+            curCosts[NumericMode] = prevCosts[NumericMode] + 20;
+            modes[NumericMode] = NumericMode;
+        }
+        if (unit.alphanumeric) {
+            curCosts[AlphanumericMode] = prevCosts[AlphanumericMode] + 33;
+            modes[AlphanumericMode] = AlphanumericMode;
+        }
+        curCosts[ByteMode] = prevCosts[ByteMode] + unit.utf8.size() * 8 * 6;
+        modes[ByteMode] = ByteMode;
+        if (!unit.kanji.isEmpty()) {
+            curCosts[KanjiMode] = prevCosts[KanjiMode] + 13 * 6;
+            modes[KanjiMode] = KanjiMode;
+        }
+
+        // 在该字符之后结束当前段并切换模式，已结束的段向上取整到整数比特
+        int appendCosts[MODE_COUNT];
+        for (int m = 0; m < MODE_COUNT; ++m) {
+            appendCosts[m] = curCosts[m];
+        }
+
+        for (int to = 0; to < MODE_COUNT; ++to) {
+            for (int from = 0; from < MODE_COUNT; ++from) {
+                if (appendCosts[from] >= UNREACHABLE) {
+                    continue;
+                }
+                const int cost = (appendCosts[from] + 5) / 6 * 6 + headCosts[to];
+                if (cost < curCosts[to]) {
+                    curCosts[to] = cost;
+                    modes[to] = static_cast<qint8>(from);
+                }
+            }
+        }
+
+        for (int m = 0; m < MODE_COUNT; ++m) {
+            prevCosts[m] = curCosts[m];
+        }
+    }
+
+    // 最后一段结束时位数最少的模式
+    int mode = 0;
+    for (int m = 1; m < MODE_COUNT; ++m) {
+        if ((prevCosts[m] + 5) / 6 < (prevCosts[mode] + 5) / 6) {
+            mode = m;
+        }
+    }
+
+    // 回溯各字符的模式
+    QVector<qint8> unitModes(count);
+    for (int i = count - 1; i >= 0; --i) {
+        mode = charModes.at(i)[mode];
+        unitModes[i] = static_cast<qint8>(mode);
+    }
+
+    // 合并相同模式的相邻字符
+    for (int i = 0; i < count; ++i) {
+        const Mode unitMode = static_cast<Mode>(unitModes.at(i));
+        if (segments.isEmpty() || segments.last().mode != unitMode) {
+            Segment segment;
+            segment.mode = unitMode;
+            segments.append(segment);
+        }
+
+        const CharUnit &unit = units.at(i);
+        segments.last().data += unitMode == KanjiMode ? unit.kanji : unit.utf8;
+    }
+
+    return segments;
+}
+
+int QRSegmentOptimizer::bitLength(const QVector<Segment> &segments, int version)
+{
+    int bits = 0;
+    for (const Segment &segment : segments) {
+        const int size = segment.data.size();
+        bits += MODE_INDICATOR_BITS + characterCountBits(segment.mode, version);
+
+        switch (segment.mode) {
+            case NumericMode:
+                bits += size / 3 * 10 + (size % 3 == 2 ? 7 : (size % 3 == 1 ? 4 : 0));
+                break;
+            case AlphanumericMode:
+                bits += size / 2 * 11 + (size % 2) * 6;
+                break;
+            case ByteMode:
+                bits += size * 8;
+                break;
+            case KanjiMode:
+                bits += size / 2 * 13;
+                break;
+        }
+    }
+    return bits;
+}
@@ -0,0 +1,67 @@
+#ifndef QRSEGMENTOPTIMIZER_H
+#define QRSEGMENTOPTIMIZER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief 二维码分段优化器
+ *
+ * 将数据划分为数字、字母数字、字节和汉字（Shift JIS）段，使总位数最少。
+ * 纯数字的序列号和大写字母数字内容因此可以用更小的版本编码。
+ * 字符计数字段的位数随版本区间（1-9、10-26、27-40）变化，需要按区间分别优化。
+ */
+class QRSegmentOptimizer
+{
+public:
+    /**
+     * @brief 编码模式
+     */
+    enum Mode {
+        NumericMode,        ///< 数字，每3位10比特
+        AlphanumericMode,   ///< 字母数字，每2个字符11比特
+        ByteMode,           ///< 字节（UTF-8），每字节8比特
+        KanjiMode           ///< 汉字（Shift JIS），每个字符13比特
+    };
+
+    /**
+     * @brief 数据段
+     */
+    struct Segment
+    {
+        Mode mode = ByteMode;   ///< 编码模式
+        QByteArray data;        ///< 段数据：数字和字母数字为ASCII，字节为UTF-8，汉字为Shift JIS
+    };
+
+    /**
+     * @brief 计算最优分段
+     *
+     * 按字符动态规划，每个字符记录以各模式结尾的最小位数（以1/6比特为单位，
+     * 使数字和字母数字的分组位数保持整数），最后回溯得到各字符的模式
+     *
+     * @param data 二维码数据
+     * @param version 目标版本（决定字符计数字段的位数）
+     * @param allowKanji 是否允许汉字模式（系统不支持Shift JIS时自动禁用）
+     * @return 分段，数据为空时为空
+     */
+    static QVector<Segment> optimize(const QString &data, int version, bool allowKanji = true);
+
+    /**
+     * @brief 计算分段的总位数
+     * @param segments 分段
+     * @param version 目标版本
+     * @return 位数（含模式指示符和字符计数字段）
+     */
+    static int bitLength(const QVector<Segment> &segments, int version);
+
+    /**
+     * @brief 获取字符计数字段的位数
+     * @param mode 编码模式
+     * @param version 版本
+     * @return 位数
+     */
+    static int characterCountBits(Mode mode, int version);
+};
+
+#endif // QRSEGMENTOPTIMIZER_H
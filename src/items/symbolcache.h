@@ -0,0 +1,145 @@
+#ifndef SYMBOLCACHE_H
+#define SYMBOLCACHE_H
+
+#include <QCache>
+#include <QMutex>
+#include <QMutexLocker>
+
+/**
+ * @brief 线程安全的LRU符号缓存
+ *
+ * 条形码符号缓存和二维码矩阵缓存的共同实现：互斥锁保护的QCache加命中统计。
+ * 查找时复制出值，调用方不持有缓存内部的指针，其他线程淘汰该项也不受影响。
+ *
+ * @tparam Key 缓存键（需要qHash()）
+ * @tparam Value 缓存的值（可复制）
+ */
+template <typename Key, typename Value>
+class SymbolCache
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param capacity 容量（总成本）
+     */
+    explicit SymbolCache(int capacity)
+        : m_cache(qMax(1, capacity))
+        , m_hits(0)
+        , m_misses(0)
+    {
+    }
+
+    /**
+     * @brief 查找值
+     * @param key 缓存键
+     * @param value 输出值
+     * @return 是否命中
+     */
+    bool find(const Key &key, Value *value)
+    {
+        QMutexLocker locker(&m_mutex);
+        // object()同时将该项标记为最近使用
+        const Value *cached = m_cache.object(key);
+        if (!cached) {
+            ++m_misses;
+            return false;
+        }
+
+        ++m_hits;
+        *value = *cached;
+        return true;
+    }
+
+    /**
+     * @brief 插入值，超出容量时淘汰最久未使用的项
+     * @param key 缓存键
+     * @param value 值
+     * @param cost 占用的容量
+     */
+    void insert(const Key &key, const Value &value, int cost = 1)
+    {
+        Value *copy = new Value(value);
+
+        QMutexLocker locker(&m_mutex);
+        m_cache.insert(key, copy, qMax(1, cost));
+    }
+
+    /**
+     * @brief 设置容量
+     * @param capacity 容量（总成本）
+     */
+    void setCapacity(int capacity)
+    {
+        QMutexLocker locker(&m_mutex);
+        m_cache.setMaxCost(qMax(1, capacity));
+    }
+
+    /**
+     * @brief 获取容量
+     * @return 容量（总成本）
+     */
+    int capacity() const
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_cache.maxCost();
+    }
+
+    /**
+     * @brief 获取当前缓存的项数
+     * @return 项数
+     */
+    int count() const
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_cache.count();
+    }
+
+    /**
+     * @brief 清空缓存
+     */
+    void clear()
+    {
+        QMutexLocker locker(&m_mutex);
+        m_cache.clear();
+    }
+
+    /**
+     * @brief 获取命中次数
+     * @return 命中次数
+     */
+    qint64 hits() const
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_hits;
+    }
+
+    /**
+     * @brief 获取未命中次数
+     * @return 未命中次数
+     */
+    qint64 misses() const
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_misses;
+    }
+
+    /**
+     * @brief 重置命中统计
+     */
+    void resetStats()
+    {
+        QMutexLocker locker(&m_mutex);
+        m_hits = 0;
+        m_misses = 0;
+    }
+
+private:
+    Q_DISABLE_COPY(SymbolCache)
+
+    mutable QMutex m_mutex;             ///< 互斥锁
+    QCache<Key, Value> m_cache;         ///< 缓存
+    qint64 m_hits;                      ///< 命中次数
+    qint64 m_misses;                    ///< 未命中次数
+};
+
+#endif // SYMBOLCACHE_H
@@ -0,0 +1,72 @@
+#include "symbolgenerator.h"
+
+#include <QCoreApplication>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+
+SymbolGenerator::SymbolGenerator()
+    : m_generation(std::make_shared<QAtomicInt>(0))
+    , m_pendingGeneration(0)
+{
+}
+
+SymbolGenerator::~SymbolGenerator()
+{
+    cancel();
+}
+
+void SymbolGenerator::start(QObject *receiver, const Task &task, const Callback &callback)
+{
+    const int generation = m_generation->fetchAndAddOrdered(1) + 1;
+    m_pendingGeneration = generation;
+
+    std::shared_ptr<QAtomicInt> latest = m_generation;
+    QPointer<QObject> guard(receiver);
+    SymbolGenerator *self = this;
+
+    QRunnable *runnable = QRunnable::create([=]() {
+        // 排队期间已被取代的任务直接跳过
+        if (latest->loadAcquire() != generation) {
+            return;
+        }
+
+        const QImage image = task();
+
+        // 结果投递到界面线程，在那里检查接收者是否仍然存在
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [=]() {
+            if (!guard || latest->loadAcquire() != generation) {
+                return;
+            }
+
+            self->m_pendingGeneration = 0;
+            callback(image);
+        }, Qt::QueuedConnection);
+    });
+
+    threadPool()->start(runnable);
+}
+
+void SymbolGenerator::cancel()
+{
+    m_generation->fetchAndAddOrdered(1);
+    m_pendingGeneration = 0;
+}
+
+bool SymbolGenerator::isPending() const
+{
+    return m_pendingGeneration != 0;
+}
+
+bool SymbolGenerator::canRunAsync()
+{
+    QCoreApplication *app = QCoreApplication::instance();
+    return app && QThread::currentThread() == app->thread();
+}
+
+QThreadPool *SymbolGenerator::threadPool()
+{
+    // 与全局线程池分开，避免批量渲染占满线程时编辑器等待
+    static QThreadPool pool;
+    return &pool;
+}
@@ -0,0 +1,89 @@
+#ifndef SYMBOLGENERATOR_H
+#define SYMBOLGENERATOR_H
+
+#include <QAtomicInt>
+#include <QImage>
+#include <QPointer>
+
+#include <functional>
+#include <memory>
+
+class QObject;
+class QThreadPool;
+
+/**
+ * @brief 后台符号图像生成器
+ *
+ * 每个条码元素持有一个实例。编辑时在线程池中生成图像，界面线程不被阻塞；
+ * 每次请求分配新的代号，被后续请求取代的任务在开始前跳过，
+ * 完成后过期的结果直接丢弃，只有最新的结果会交给元素。
+ * 结果到达前元素继续绘制上一张有效图像。
+ */
+class SymbolGenerator
+{
+public:
+    /**
+     * @brief 图像生成任务（在工作线程中执行，只能使用按值捕获的数据）
+     */
+    using Task = std::function<QImage()>;
+
+    /**
+     * @brief 结果回调（在界面线程中执行）
+     */
+    using Callback = std::function<void(const QImage &image)>;
+
+    /**
+     * @brief 构造函数
+     */
+    SymbolGenerator();
+
+    /**
+     * @brief 析构函数，取消未完成的任务
+     */
+    ~SymbolGenerator();
+
+    /**
+     * @brief 在后台生成图像
+     *
+     * 取代之前所有未完成的请求
+     *
+     * @param receiver 接收结果的对象（必须属于界面线程），销毁后结果被丢弃
+     * @param task 生成任务
+     * @param callback 结果回调
+     */
+    void start(QObject *receiver, const Task &task, const Callback &callback);
+
+    /**
+     * @brief 取消未完成的请求
+     */
+    void cancel();
+
+    /**
+     * @brief 是否有未完成的请求
+     * @return 是否在等待结果
+     */
+    bool isPending() const;
+
+    /**
+     * @brief 判断当前线程是否可以使用后台生成
+     *
+     * 只有界面线程才能接收结果；渲染线程等没有事件循环的场合应同步生成
+     *
+     * @return 是否可以异步生成
+     */
+    static bool canRunAsync();
+
+    /**
+     * @brief 获取符号生成专用的线程池
+     * @return 线程池
+     */
+    static QThreadPool *threadPool();
+
+private:
+    Q_DISABLE_COPY(SymbolGenerator)
+
+    std::shared_ptr<QAtomicInt> m_generation;   ///< 最新请求的代号（与工作线程共享）
+    int m_pendingGeneration;                    ///< 等待结果的代号，0表示没有
+};
+
+#endif // SYMBOLGENERATOR_H
@@ -34,7 +34,7 @@ TextItem::TextItem(QGraphicsItem *parent)
     setName(tr("文本"));
 
     // 初始化文本文档
-    updateContent();
+    invalidateContent();
 
     // 设置大小
     QSizeF size = sizeHint();
@@ -197,7 +197,7 @@ bool TextItem::loadFromXml(const QDomElement &element)
     }
 
     // 更新内容
-    updateContent();
+    invalidateContent();
 
     return true;
 }
@@ -304,7 +304,7 @@ bool TextItem::fromJson(const QJsonObject &json)
     }
 
     // 更新内容
-    updateContent();
+    invalidateContent();
 
     return true;
 }
@@ -332,7 +332,7 @@ LabelItem* TextItem::clone() const
     clone->m_borderColor = m_borderColor;
 
     // 更新内容
-    clone->updateContent();
+    clone->invalidateContent();
 
     return clone;
 }
@@ -373,7 +373,7 @@ void TextItem::setText(const QString &text)
     }
 
     m_text = text;
-    updateContent();
+    invalidateContent();
     setModified(true);
     emit textChanged(text);
     emit itemChanged();
@@ -391,7 +391,7 @@ void TextItem::setFont(const QFont &font)
     }
 
     m_font = font;
-    updateContent();
+    invalidateContent();
     setModified(true);
     emit fontChanged(font);
     emit itemChanged();
@@ -409,7 +409,7 @@ void TextItem::setTextColor(const QColor &color)
     }
 
     m_textColor = color;
-    updateContent();
+    invalidateContent();
     setModified(true);
     emit textColorChanged(color);
     emit itemChanged();
@@ -445,7 +445,7 @@ void TextItem::setAlignment(Qt::Alignment alignment)
     }
 
     m_alignment = alignment;
-    updateContent();
+    invalidateContent();
     setModified(true);
     emit alignmentChanged(alignment);
     emit itemChanged();
@@ -463,7 +463,7 @@ void TextItem::setWordWrap(bool wrap)
     }
 
     m_wordWrap = wrap;
-    updateContent();
+    invalidateContent();
     setModified(true);
     emit wordWrapChanged(wrap);
     emit itemChanged();
@@ -1,5 +1,6 @@
 #include "application.h"
 #include "mainwindow.h"
+#include "headlessrenderer.h"
 
 #include <QApplication>
 #include <QCommandLineParser>
@@ -18,6 +19,21 @@ int main(int argc, char *argv[])
     QApplication::setAttribute(Qt::AA_EnableHighDpiScaling);
     QApplication::setAttribute(Qt::AA_UseHighDpiPixmaps);
 
+    // 无界面渲染模式：不创建主窗口和启动画面，渲染完成后直接退出
+    if (HeadlessRenderer::isRequested(argc, argv)) {
+        // 没有显示环境时使用offscreen平台插件
+        if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+
+        QApplication app(argc, argv);
+        app.setApplicationName("Label Printer Editor");
+        app.setApplicationVersion("1.0.0");
+
+        HeadlessRenderer renderer;
+        return renderer.run(app.arguments());
+    }
+
     // 创建应用程序实例
     Application app(argc, argv);
 
@@ -4,6 +4,9 @@
 #include "ui/labeleditview.h"
 #include "ui/propertiespanel.h"
 #include "application.h"
+#include "print/zplexporter.h"
+#include "print/printsink.h"
+#include "print/printspooler.h"
 
 #include <QMessageBox>
 #include <QFileDialog>
@@ -26,6 +29,7 @@ MainWindow::MainWindow(QWidget *parent)
     , ui(new Ui::MainWindow)
     , m_undoStack(new QUndoStack(this))
     , m_currentDocument(nullptr)
+    , m_spooler(nullptr)
 {
     // 设置UI
     ui->setupUi(this);
@@ -68,6 +72,8 @@ MainWindow::MainWindow(QWidget *parent)
 
 MainWindow::~MainWindow()
 {
+    // 等待打印线程退出后再释放打印机
+    delete m_spooler;
     delete ui;
 }
 
@@ -177,9 +183,11 @@ void MainWindow::exportAsPDF()
         // 执行打印
         QPainter painter;
         if (painter.begin(&printer)) {
-            m_currentDocument->render(&painter, printer.pageRect());
+            RenderStats stats;
+            m_currentDocument->render(&painter, printer.pageRect(), &stats);
             painter.end();
 
+            showRenderStats(stats);
             QMessageBox::information(this, tr("导出成功"),
                 tr("文档已成功导出为PDF。"));
         } else {
@@ -189,27 +197,81 @@ void MainWindow::exportAsPDF()
     }
 }
 
+void MainWindow::exportAsZPL()
+{
+    QString fileName = QFileDialog::getSaveFileName(this,
+        tr("导出为ZPL"), QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation),
+        tr("ZPL文件 (*.zpl)"));
+
+    if (!fileName.isEmpty()) {
+        // 按文档分辨率生成打印机原生命令
+        ZplExporter exporter(m_currentDocument);
+        if (exporter.exportToFile(fileName)) {
+            QMessageBox::information(this, tr("导出成功"),
+                tr("文档已成功导出为ZPL（原生字段 %1 个，图形字段 %2 个）。")
+                    .arg(exporter.nativeFieldCount())
+                    .arg(exporter.graphicFieldCount()));
+        } else {
+            QMessageBox::warning(this, tr("导出失败"),
+                tr("无法导出文档为ZPL。"));
+        }
+    }
+}
+
+bool MainWindow::printerBusy()
+{
+    // 发送线程正在使用打印机，界面线程不能同时绘制或修改设置
+    if (m_spooler && m_spooler->pendingJobs() > 0) {
+        QMessageBox::information(this, tr("打印"),
+            tr("上一个打印任务尚未完成。"));
+        return true;
+    }
+    return false;
+}
+
 void MainWindow::printDocument()
 {
+    // 打印期间不能修改打印机设置
+    if (printerBusy()) {
+        return;
+    }
+
     // 配置打印机
     QPrintDialog dialog(&m_printer, this);
     if (dialog.exec() == QDialog::Accepted) {
-        // 执行打印
-        QPainter painter;
-        if (painter.begin(&m_printer)) {
-            m_currentDocument->render(&painter, m_printer.pageRect());
-            painter.end();
+        if (!m_spooler) {
+            m_spooler = new PrintSpooler(new PrinterPrintSink(&m_printer), 8, this);
+            connect(m_spooler, &PrintSpooler::jobFinished, this,
+                    [this](int jobId, bool success, const QString &errorString) {
+                Q_UNUSED(jobId)
+                if (success) {
+                    statusBar()->showMessage(tr("打印完成"), 2000);
+                } else {
+                    QMessageBox::warning(this, tr("打印失败"),
+                        tr("无法打印文档：%1").arg(errorString));
+                }
+            });
+        }
 
-            statusBar()->showMessage(tr("打印完成"), 2000);
-        } else {
+        // 在后台线程渲染并打印，界面不被阻塞
+        m_spooler->setResolution(m_printer.resolution());
+        if (m_spooler->submit(m_currentDocument) < 0) {
             QMessageBox::warning(this, tr("打印失败"),
                 tr("无法打印文档。"));
+            return;
         }
+
+        statusBar()->showMessage(tr("正在打印..."));
     }
 }
 
 void MainWindow::printPreview()
 {
+    // 预览也在打印机上绘制，不能与后台打印同时进行
+    if (printerBusy()) {
+        return;
+    }
+
     // 创建打印预览对话框
     QPrintPreviewDialog preview(&m_printer, this);
 
@@ -218,8 +280,11 @@ void MainWindow::printPreview()
             this, [this](QPrinter *printer) {
                 QPainter painter;
                 if (painter.begin(printer)) {
-                    m_currentDocument->render(&painter, printer->pageRect());
+                    RenderStats stats;
+                    m_currentDocument->render(&painter, printer->pageRect(), &stats);
                     painter.end();
+
+                    showRenderStats(stats);
                 }
             });
 
@@ -314,6 +379,10 @@ void MainWindow::snapToGridToggled(bool checked)
 
 void MainWindow::showPageSetupDialog()
 {
+    if (printerBusy()) {
+        return;
+    }
+
     // 创建页面设置对话框
     QPageSetupDialog dialog(&m_printer, this);
     if (dialog.exec() == QDialog::Accepted) {
@@ -328,6 +397,10 @@ void MainWindow::showPageSetupDialog()
 
 void MainWindow::showPrinterSettingsDialog()
 {
+    if (printerBusy()) {
+        return;
+    }
+
     // 创建打印机设置对话框
     QPrinterInfo printerInfo(m_printer);
     QPrintDialog dialog(&m_printer, this);
@@ -405,6 +478,7 @@ void MainWindow::connectSignals()
     connect(ui->actionSave, &QAction::triggered, this, &MainWindow::saveDocument);
     connect(ui->actionSaveAs, &QAction::triggered, this, &MainWindow::saveDocumentAs);
     connect(ui->actionExportPDF, &QAction::triggered, this, &MainWindow::exportAsPDF);
+    connect(ui->actionExportZPL, &QAction::triggered, this, &MainWindow::exportAsZPL);
     connect(ui->actionPrint, &QAction::triggered, this, &MainWindow::printDocument);
     connect(ui->actionPrintPreview, &QAction::triggered, this, &MainWindow::printPreview);
     connect(ui->actionExit, &QAction::triggered, this, &QWidget::close);
@@ -479,6 +553,14 @@ void MainWindow::updateWindowTitle()
     setWindowTitle(title);
 }
 
+void MainWindow::showRenderStats(const RenderStats &stats)
+{
+    statusBar()->showMessage(tr("已绘制 %1 个元素，跳过 %2 个，耗时 %3 毫秒")
+                             .arg(stats.itemsPainted)
+                             .arg(stats.itemsCulled)
+                             .arg(stats.elapsedNs / 1000000.0, 0, 'f', 1), 5000);
+}
+
 bool MainWindow::maybeSave()
 {
     if (!isWindowModified()) {
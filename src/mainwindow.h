@@ -11,6 +11,8 @@
 class LabelEditView;
 class PropertiesPanel;
 class LabelDocument;
+class PrintSpooler;
+struct RenderStats;
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -37,6 +39,7 @@ private slots:
     void saveDocument();
     void saveDocumentAs();
     void exportAsPDF();
+    void exportAsZPL();
     void printDocument();
     void printPreview();
 
@@ -81,6 +84,10 @@ private:
     // 更新UI状态
     void updateActions();
     void updateWindowTitle();
+    void showRenderStats(const RenderStats &stats);
+
+    // 打印任务未完成时提示用户，此时不能使用或修改打印机
+    bool printerBusy();
 
     // 文件操作辅助函数
     bool maybeSave();
@@ -100,6 +107,7 @@ private:
 
     // 打印
     QPrinter printer;
+    PrintSpooler *m_spooler;
 
     // 撤销/重做堆栈
     QUndoStack *undoStack;
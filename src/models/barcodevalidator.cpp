@@ -0,0 +1,342 @@
+#include "barcodevalidator.h"
+#include "../items/barcodeitem.h"
+
+#include <QObject>
+
+#include <array>
+#include <cstring>
+
+// 字符类别
+static const quint8 CLASS_ANY = 0x01;      // 任意字节
+static const quint8 CLASS_ASCII = 0x02;    // ASCII（Code 128）
+static const quint8 CLASS_CODE39 = 0x04;   // Code 39 字符集
+static const quint8 CLASS_DIGIT = 0x08;    // 数字
+
+// 生成按字节索引的字符类别表
+static constexpr std::array<quint8, 256> makeCharClasses()
+{
+    std::array<quint8, 256> classes = {};
+    const char code39[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ-. $/+%*";
+
+    for (int c = 0; c < 256; ++c) {
+        classes[c] = CLASS_ANY;
+        if (c < 128) {
+            classes[c] |= CLASS_ASCII;
+        }
+        if (c >= '0' && c <= '9') {
+            classes[c] |= CLASS_DIGIT;
+        }
+    }
+    for (int i = 0; code39[i]; ++i) {
+        classes[static_cast<uchar>(code39[i])] |= CLASS_CODE39;
+    }
+    return classes;
+}
+
+static constexpr std::array<quint8, 256> charClasses = makeCharClasses();
+
+// 返回第一个非数字字节的位置，全部为数字时返回-1
+static int firstNonDigit(const char *data, int length)
+{
+    // 每次检查8个字节：小于'0'的字节减去0x30后借位置高位，
+    // 大于'9'的字节加上0x46后进位到高位，非ASCII字节本身高位为1
+    const quint64 low = Q_UINT64_C(0x3030303030303030);
+    const quint64 high = Q_UINT64_C(0x4646464646464646);
+    const quint64 sign = Q_UINT64_C(0x8080808080808080);
+
+    int i = 0;
+    for (; i + 8 <= length; i += 8) {
+        quint64 word;
+        memcpy(&word, data + i, sizeof(word));
+        if ((word | (word - low) | (word + high)) & sign) {
+            break;
+        }
+    }
+
+    // 剩余字节以及出错的那一组逐个检查，得到准确位置
+    for (; i < length; ++i) {
+        const uchar c = static_cast<uchar>(data[i]);
+        if (c < '0' || c > '9') {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// 返回第一个不属于指定类别的字节位置，全部符合时返回-1
+static int firstInvalid(const char *data, int length, quint8 charClass)
+{
+    if (charClass == CLASS_DIGIT) {
+        return firstNonDigit(data, length);
+    }
+    if (charClass == CLASS_ANY) {
+        return -1;
+    }
+
+    for (int i = 0; i < length; ++i) {
+        if (!(charClasses[static_cast<uchar>(data[i])] & charClass)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+BarcodeDataValidator::BarcodeDataValidator(BarcodeType type)
+    : m_type(type)
+    , m_minLength(1)
+    , m_maxLength(0)
+    , m_charClass(CLASS_ANY)
+    , m_dataDigits(dataDigits(type))
+    , m_evenLength(false)
+    , m_repairChecksum(false)
+{
+    switch (type) {
+        case BarcodeType::Code128:
+            m_maxLength = 80;
+            m_charClass = CLASS_ASCII;
+            break;
+
+        case BarcodeType::Code39:
+            m_maxLength = 80;
+            m_charClass = CLASS_CODE39;
+            break;
+
+        case BarcodeType::UPC_E:
+            m_minLength = 6;
+            m_maxLength = 8;
+            m_charClass = CLASS_DIGIT;
+            break;
+
+        case BarcodeType::Interleaved2of5:
+            // 数字成对编码，ZXing的ITF编码器拒绝奇数位
+            m_charClass = CLASS_DIGIT;
+            m_evenLength = true;
+            break;
+
+        default:
+            // 有固定校验位的类型：可以缺少校验位
+            if (m_dataDigits > 0) {
+                m_minLength = m_dataDigits;
+                m_maxLength = m_dataDigits + 1;
+                m_charClass = CLASS_DIGIT;
+            }
+            break;
+    }
+}
+
+BarcodeType BarcodeDataValidator::type() const
+{
+    return m_type;
+}
+
+void BarcodeDataValidator::setRepairChecksum(bool repair)
+{
+    m_repairChecksum = repair;
+}
+
+bool BarcodeDataValidator::repairChecksum() const
+{
+    return m_repairChecksum;
+}
+
+QVector<BarcodeDataValidator::RowError> BarcodeDataValidator::validate(const QByteArray &records,
+                                                                       QByteArray *output) const
+{
+    QVector<RowError> errors;
+
+    if (output) {
+        output->clear();
+        // 每行最多多出一个校验位
+        output->reserve(records.size() + records.size() / qMax(1, m_minLength) + 1);
+    }
+
+    const char *begin = records.constData();
+    const char *end = begin + records.size();
+    const char *line = begin;
+    int row = 0;
+
+    while (line < end) {
+        const char *next = static_cast<const char*>(memchr(line, '\n', end - line));
+        if (!next) {
+            next = end;
+        }
+
+        int length = static_cast<int>(next - line);
+        if (length > 0 && line[length - 1] == '\r') {
+            --length;
+        }
+
+        int position = -1;
+        char checksum = 0;
+        const Error error = checkRow(line, length, &position, &checksum);
+
+        if (error != NoError) {
+            errors.append({row, error, position});
+        }
+
+        if (output) {
+            output->append(line, length);
+            if (!isFatal(error) && checksum) {
+                if (length == m_dataDigits) {
+                    output->append(checksum);
+                } else {
+                    (*output)[output->size() - 1] = checksum;
+                }
+            }
+            output->append('\n');
+        }
+
+        line = next + 1;
+        ++row;
+    }
+
+    return errors;
+}
+
+QVector<BarcodeDataValidator::RowError> BarcodeDataValidator::validate(const QStringList &values,
+                                                                       QStringList *output) const
+{
+    QVector<RowError> errors;
+
+    if (output) {
+        output->clear();
+        output->reserve(values.size());
+    }
+
+    for (int row = 0; row < values.size(); ++row) {
+        const QString &value = values.at(row);
+        const QByteArray bytes = value.toUtf8();
+
+        int position = -1;
+        char checksum = 0;
+        const Error error = checkRow(bytes.constData(), bytes.size(), &position, &checksum);
+
+        if (error != NoError) {
+            errors.append({row, error, position});
+        }
+
+        if (output) {
+            if (!isFatal(error) && checksum) {
+                output->append(value.left(m_dataDigits) + QLatin1Char(checksum));
+            } else {
+                output->append(value);
+            }
+        }
+    }
+
+    return errors;
+}
+
+BarcodeDataValidator::Error BarcodeDataValidator::check(const QString &value, QString *output) const
+{
+    const QByteArray bytes = value.toUtf8();
+
+    int position = -1;
+    char checksum = 0;
+    const Error error = checkRow(bytes.constData(), bytes.size(), &position, &checksum);
+
+    if (output) {
+        if (!isFatal(error) && checksum) {
+            *output = value.left(m_dataDigits) + QLatin1Char(checksum);
+        } else {
+            *output = value;
+        }
+    }
+
+    return error;
+}
+
+bool BarcodeDataValidator::isFatal(Error error)
+{
+    return error != NoError && error != ChecksumRepaired;
+}
+
+int BarcodeDataValidator::dataDigits(BarcodeType type)
+{
+    switch (type) {
+        case BarcodeType::EAN8:
+            return 7;
+        case BarcodeType::EAN13:
+            return 12;
+        case BarcodeType::UPC_A:
+            return 11;
+        case BarcodeType::ITF14:
+            return 13;
+        default:
+            return 0;
+    }
+}
+
+char BarcodeDataValidator::checksumDigit(const char *digits, int length)
+{
+    // 从右向左权重依次为3、1
+    int sum = 0;
+    int weight = 3;
+    for (int i = length - 1; i >= 0; --i) {
+        sum += (digits[i] - '0') * weight;
+        weight = 4 - weight;
+    }
+    return static_cast<char>('0' + (10 - sum % 10) % 10);
+}
+
+QString BarcodeDataValidator::errorString(Error error)
+{
+    switch (error) {
+        case NoError:
+            return QObject::tr("无错误");
+        case EmptyData:
+            return QObject::tr("数据为空");
+        case InvalidLength:
+            return QObject::tr("长度不符合要求");
+        case InvalidCharacter:
+            return QObject::tr("包含不支持的字符");
+        case ChecksumMismatch:
+            return QObject::tr("校验位错误");
+        case ChecksumRepaired:
+            return QObject::tr("校验位错误（已修正）");
+    }
+    return QString();
+}
+
+BarcodeDataValidator::Error BarcodeDataValidator::checkRow(const char *data, int length,
+                                                           int *position, char *checksum) const
+{
+    *position = -1;
+    *checksum = 0;
+
+    if (length == 0) {
+        return EmptyData;
+    }
+    if (length < m_minLength || (m_maxLength > 0 && length > m_maxLength) || (m_evenLength && length % 2 != 0)) {
+        return InvalidLength;
+    }
+
+    const int invalid = firstInvalid(data, length, m_charClass);
+    if (invalid >= 0) {
+        *position = invalid;
+        return InvalidCharacter;
+    }
+
+    if (m_dataDigits > 0) {
+        const char expected = checksumDigit(data, m_dataDigits);
+        if (length > m_dataDigits) {
+            if (data[m_dataDigits] == expected) {
+                // 校验位正确，无需改动
+                return NoError;
+            }
+
+            *position = m_dataDigits;
+            if (!m_repairChecksum) {
+                return ChecksumMismatch;
+            }
+
+            *checksum = expected;
+            return ChecksumRepaired;
+        }
+
+        // 缺少校验位时补全
+        *checksum = expected;
+    }
+
+    return NoError;
+}
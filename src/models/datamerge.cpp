@@ -0,0 +1,485 @@
+#include "datamerge.h"
+#include "labelmodels.h"
+#include "../items/labelitem.h"
+#include "../items/textitem.h"
+#include "../items/barcodeitem.h"
+#include "../items/barcodesymbol.h"
+#include "../items/qrcodeitem.h"
+
+#include <QIODevice>
+#include <QMap>
+#include <QObject>
+#include <QDebug>
+
+// 占位符起止标记
+static const QString PLACEHOLDER_BEGIN = QStringLiteral("{{");
+static const QString PLACEHOLDER_END = QStringLiteral("}}");
+
+// ================= DataRecordReader 类实现 =================
+
+DataRecordReader::DataRecordReader(QIODevice *device, QChar delimiter)
+    : m_stream(device)
+    , m_delimiter(delimiter)
+    , m_recordCount(0)
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    m_stream.setCodec("UTF-8");
+#endif
+}
+
+bool DataRecordReader::readHeader()
+{
+    if (m_stream.atEnd()) {
+        return false;
+    }
+
+    // 自动识别分隔符
+    if (m_delimiter.isNull()) {
+        qint64 start = m_stream.pos();
+        QString firstLine = m_stream.readLine();
+        m_stream.seek(start);
+
+        int tabs = firstLine.count('\t');
+        int semicolons = firstLine.count(';');
+        int commas = firstLine.count(',');
+
+        if (tabs > 0 && tabs >= semicolons && tabs >= commas) {
+            m_delimiter = '\t';
+        } else if (semicolons > commas) {
+            m_delimiter = ';';
+        } else {
+            m_delimiter = ',';
+        }
+    }
+
+    if (!readFields(&m_columns)) {
+        return false;
+    }
+
+    // 去掉UTF-8 BOM和列名两侧的空白
+    if (!m_columns.isEmpty() && m_columns.first().startsWith(QChar(0xFEFF))) {
+        m_columns.first().remove(0, 1);
+    }
+    for (QString &column : m_columns) {
+        column = column.trimmed();
+    }
+
+    return !m_columns.isEmpty();
+}
+
+QStringList DataRecordReader::columns() const
+{
+    return m_columns;
+}
+
+bool DataRecordReader::readRecord(QStringList *fields)
+{
+    if (!fields) {
+        return false;
+    }
+
+    // 跳过空行
+    do {
+        if (!readFields(fields)) {
+            return false;
+        }
+    } while (fields->size() == 1 && fields->first().isEmpty());
+
+    // 列数不足时补齐，方便按列索引直接访问
+    while (fields->size() < m_columns.size()) {
+        fields->append(QString());
+    }
+
+    ++m_recordCount;
+    return true;
+}
+
+int DataRecordReader::recordCount() const
+{
+    return m_recordCount;
+}
+
+QChar DataRecordReader::delimiter() const
+{
+    return m_delimiter;
+}
+
+bool DataRecordReader::readFields(QStringList *fields)
+{
+    if (m_stream.atEnd()) {
+        return false;
+    }
+
+    fields->clear();
+
+    QString line = m_stream.readLine();
+    QString field;
+    bool inQuotes = false;
+    int i = 0;
+
+    forever {
+        if (i >= line.size()) {
+            if (inQuotes && !m_stream.atEnd()) {
+                // 引号内的换行属于字段内容，继续读取下一行
+                field += '\n';
+                line = m_stream.readLine();
+                i = 0;
+                continue;
+            }
+            break;
+        }
+
+        const QChar c = line.at(i);
+
+        if (inQuotes) {
+            if (c == '"') {
+                if (i + 1 < line.size() && line.at(i + 1) == '"') {
+                    // 转义的双引号
+                    field += '"';
+                    ++i;
+                } else {
+                    inQuotes = false;
+                }
+            } else {
+                field += c;
+            }
+        } else if (c == '"' && field.isEmpty()) {
+            inQuotes = true;
+        } else if (c == m_delimiter) {
+            fields->append(field);
+            field.clear();
+        } else {
+            field += c;
+        }
+
+        ++i;
+    }
+
+    fields->append(field);
+    return true;
+}
+
+// ================= DataMergeEngine 类实现 =================
+
+DataMergeEngine::DataMergeEngine(LabelDocument *document)
+    : m_document(nullptr)
+{
+    if (document) {
+        bind(document);
+    }
+}
+
+void DataMergeEngine::bind(LabelDocument *document)
+{
+    m_document = document;
+    m_bindings.clear();
+
+    if (!m_document) {
+        return;
+    }
+
+    // 只记录包含占位符的元素，应用记录时不再遍历整个文档
+    for (LabelItem *item : m_document->items()) {
+        QString text;
+        if (!itemContent(item, &text) || !hasPlaceholders(text)) {
+            continue;
+        }
+
+        Binding binding;
+        binding.item = item;
+        binding.templateText = text;
+        binding.segments = parseTemplate(text);
+        if (item->type() == LabelItem::BarcodeType) {
+            binding.validator = std::make_shared<BarcodeDataValidator>(static_cast<const BarcodeItem*>(item)->type());
+        }
+        m_bindings.append(binding);
+    }
+
+    // 重新解析已设置的列
+    if (!m_columns.isEmpty()) {
+        setColumns(m_columns);
+    }
+}
+
+void DataMergeEngine::setColumns(const QStringList &columns)
+{
+    m_columns = columns;
+
+    for (Binding &binding : m_bindings) {
+        for (Segment &segment : binding.segments) {
+            if (segment.field.isEmpty()) {
+                continue;
+            }
+
+            // 优先精确匹配，其次忽略大小写匹配
+            segment.column = m_columns.indexOf(segment.field);
+            if (segment.column < 0) {
+                for (int i = 0; i < m_columns.size(); ++i) {
+                    if (m_columns.at(i).compare(segment.field, Qt::CaseInsensitive) == 0) {
+                        segment.column = i;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+}
+
+QList<LabelItem*> DataMergeEngine::boundItems() const
+{
+    QList<LabelItem*> items;
+    for (const Binding &binding : m_bindings) {
+        items.append(binding.item);
+    }
+    return items;
+}
+
+QStringList DataMergeEngine::fields() const
+{
+    QStringList result;
+    for (const Binding &binding : m_bindings) {
+        for (const Segment &segment : binding.segments) {
+            if (!segment.field.isEmpty() && !result.contains(segment.field)) {
+                result.append(segment.field);
+            }
+        }
+    }
+    return result;
+}
+
+QStringList DataMergeEngine::missingColumns() const
+{
+    QStringList result;
+    for (const Binding &binding : m_bindings) {
+        for (const Segment &segment : binding.segments) {
+            if (!segment.field.isEmpty() && segment.column < 0 && !result.contains(segment.field)) {
+                result.append(segment.field);
+            }
+        }
+    }
+    return result;
+}
+
+bool DataMergeEngine::apply(const QStringList &record, QString *errorString)
+{
+    // 先合并、验证并试编码全部内容，再统一写入元素
+    QStringList texts;
+    texts.reserve(m_bindings.size());
+
+    for (const Binding &binding : m_bindings) {
+        QString text = mergeText(binding, record);
+
+        if (binding.validator) {
+            // 写入补全或修正校验位后的值
+            QString completed;
+            const BarcodeDataValidator::Error error = binding.validator->check(text, &completed);
+            if (BarcodeDataValidator::isFatal(error)) {
+                if (errorString) {
+                    *errorString = invalidValueString(binding, text, error);
+                }
+                return false;
+            }
+            text = completed;
+        }
+
+        // 编码器不支持的值同样视为无效，不能沿用旧数据
+        if (!canEncode(binding, text)) {
+            if (errorString) {
+                *errorString = QObject::tr("元素“%1”无法编码条形码数据“%2”")
+                                   .arg(binding.item->name(), text);
+            }
+            return false;
+        }
+
+        texts.append(text);
+    }
+
+    // 保存原内容，元素仍然拒绝时整条记录回滚
+    QStringList previous;
+    previous.reserve(m_bindings.size());
+    for (const Binding &binding : m_bindings) {
+        QString text;
+        itemContent(binding.item, &text);
+        previous.append(text);
+    }
+
+    for (int i = 0; i < m_bindings.size(); ++i) {
+        const Binding &binding = m_bindings.at(i);
+        setItemContent(binding.item, texts.at(i));
+
+        QString stored;
+        if (binding.validator && (!itemContent(binding.item, &stored) || stored != texts.at(i))) {
+            for (int j = 0; j <= i; ++j) {
+                setItemContent(m_bindings.at(j).item, previous.at(j));
+            }
+            if (errorString) {
+                *errorString = QObject::tr("元素“%1”无法编码条形码数据“%2”")
+                                   .arg(binding.item->name(), texts.at(i));
+            }
+            return false;
+        }
+    }
+
+    return true;
+}
+
+QVector<DataMergeEngine::RecordError> DataMergeEngine::validate(const QList<QStringList> &records) const
+{
+    // 按记录序号排序，每条记录保留第一个错误
+    QMap<int, QString> errors;
+    QStringList values;
+
+    for (const Binding &binding : m_bindings) {
+        if (!binding.validator) {
+            continue;
+        }
+
+        values.clear();
+        values.reserve(records.size());
+        for (const QStringList &record : records) {
+            values.append(mergeText(binding, record));
+        }
+
+        for (const BarcodeDataValidator::RowError &rowError : binding.validator->validate(values)) {
+            if (BarcodeDataValidator::isFatal(rowError.error) && !errors.contains(rowError.row)) {
+                errors.insert(rowError.row, invalidValueString(binding, values.at(rowError.row), rowError.error));
+            }
+        }
+    }
+
+    QVector<RecordError> result;
+    result.reserve(errors.size());
+    for (auto it = errors.constBegin(); it != errors.constEnd(); ++it) {
+        result.append({it.key(), it.value()});
+    }
+    return result;
+}
+
+void DataMergeEngine::restore()
+{
+    for (const Binding &binding : m_bindings) {
+        setItemContent(binding.item, binding.templateText);
+    }
+}
+
+bool DataMergeEngine::hasPlaceholders(const QString &text)
+{
+    int begin = text.indexOf(PLACEHOLDER_BEGIN);
+    return begin >= 0 && text.indexOf(PLACEHOLDER_END, begin + PLACEHOLDER_BEGIN.size()) >= 0;
+}
+
+QVector<DataMergeEngine::Segment> DataMergeEngine::parseTemplate(const QString &text)
+{
+    QVector<Segment> segments;
+    int pos = 0;
+
+    while (pos < text.size()) {
+        int begin = text.indexOf(PLACEHOLDER_BEGIN, pos);
+        int end = begin < 0 ? -1 : text.indexOf(PLACEHOLDER_END, begin + PLACEHOLDER_BEGIN.size());
+
+        if (begin < 0 || end < 0) {
+            // 剩余部分都是文字
+            segments.append({text.mid(pos), QString(), -1});
+            break;
+        }
+
+        if (begin > pos) {
+            segments.append({text.mid(pos, begin - pos), QString(), -1});
+        }
+
+        QString field = text.mid(begin + PLACEHOLDER_BEGIN.size(),
+                                 end - begin - PLACEHOLDER_BEGIN.size()).trimmed();
+        if (field.isEmpty()) {
+            // 空占位符按原样保留
+            segments.append({text.mid(begin, end + PLACEHOLDER_END.size() - begin), QString(), -1});
+        } else {
+            segments.append({QString(), field, -1});
+        }
+
+        pos = end + PLACEHOLDER_END.size();
+    }
+
+    return segments;
+}
+
+QString DataMergeEngine::mergeText(const Binding &binding, const QStringList &record)
+{
+    QString text;
+    for (const Segment &segment : binding.segments) {
+        if (segment.field.isEmpty()) {
+            text += segment.literal;
+        } else if (segment.column >= 0 && segment.column < record.size()) {
+            text += record.at(segment.column);
+        }
+    }
+    return text;
+}
+
+QString DataMergeEngine::invalidValueString(const Binding &binding, const QString &value,
+                                            BarcodeDataValidator::Error error)
+{
+    return QObject::tr("元素“%1”的条形码数据“%2”无效：%3")
+        .arg(binding.item->name(), value, BarcodeDataValidator::errorString(error));
+}
+
+bool DataMergeEngine::canEncode(const Binding &binding, const QString &value)
+{
+    if (binding.item->type() != LabelItem::BarcodeType) {
+        return true;
+    }
+
+    const BarcodeItem *barcode = static_cast<const BarcodeItem*>(binding.item);
+
+    // 只编码一次（结果进入缓存，渲染时直接命中）；ZXing成功即可用
+    const BarcodeSymbol symbol = BarcodeSymbol::encode(value, barcode->type(), barcode->includeChecksum());
+    if (!symbol.isValid()) {
+        return false;
+    }
+    if (!symbol.isFallback()) {
+        return true;
+    }
+
+    // 没有专用内置编码器的类型不能接受Code 128的替代结果
+    return BarcodeItem::hasFallbackEncoder(barcode->type())
+           && BarcodeItem::validateData(value, barcode->type());
+}
+
+bool DataMergeEngine::itemContent(const LabelItem *item, QString *text)
+{
+    switch (item->type()) {
+        case LabelItem::TextType:
+            *text = static_cast<const TextItem*>(item)->text();
+            return true;
+
+        case LabelItem::BarcodeType:
+            *text = static_cast<const BarcodeItem*>(item)->data();
+            return true;
+
+        case LabelItem::QRCodeType:
+            *text = static_cast<const QRCodeItem*>(item)->data();
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+void DataMergeEngine::setItemContent(LabelItem *item, const QString &text)
+{
+    switch (item->type()) {
+        case LabelItem::TextType:
+            static_cast<TextItem*>(item)->setText(text);
+            break;
+
+        case LabelItem::BarcodeType:
+            static_cast<BarcodeItem*>(item)->setData(text);
+            break;
+
+        case LabelItem::QRCodeType:
+            static_cast<QRCodeItem*>(item)->setData(text);
+            break;
+
+        default:
+            break;
+    }
+}
@@ -0,0 +1,258 @@
+#ifndef DATAMERGE_H
+#define DATAMERGE_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QList>
+#include <QVector>
+#include <QTextStream>
+
+#include <memory>
+
+#include "barcodevalidator.h"
+
+class QIODevice;
+class LabelDocument;
+class LabelItem;
+
+/**
+ * @brief 数据记录读取器
+ *
+ * 按记录流式读取CSV/TSV文件，第一行为列名。
+ * 支持双引号包裹的字段（字段内可包含分隔符、换行和转义的双引号），
+ * 每次只在内存中保留一条记录。
+ */
+class DataRecordReader
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param device 输入设备（需已打开）
+     * @param delimiter 字段分隔符，为空时根据表头自动识别（制表符、分号或逗号）
+     */
+    explicit DataRecordReader(QIODevice *device, QChar delimiter = QChar());
+
+    /**
+     * @brief 读取表头
+     * @return 是否读取成功
+     */
+    bool readHeader();
+
+    /**
+     * @brief 获取列名列表
+     * @return 列名列表
+     */
+    QStringList columns() const;
+
+    /**
+     * @brief 读取下一条记录
+     * @param fields 输出的字段值，列数不足时补空字符串
+     * @return 如果读到记录则返回true，到达文件末尾返回false
+     */
+    bool readRecord(QStringList *fields);
+
+    /**
+     * @brief 获取已读取的记录数量（不含表头）
+     * @return 记录数量
+     */
+    int recordCount() const;
+
+    /**
+     * @brief 获取当前使用的分隔符
+     * @return 分隔符
+     */
+    QChar delimiter() const;
+
+private:
+    /**
+     * @brief 读取一行完整的记录文本并拆分为字段
+     * @param fields 输出的字段值
+     * @return 是否读取成功
+     */
+    bool readFields(QStringList *fields);
+
+    QTextStream m_stream;       ///< 文本流
+    QChar m_delimiter;          ///< 字段分隔符
+    QStringList m_columns;      ///< 列名
+    int m_recordCount;          ///< 已读取记录数
+};
+
+/**
+ * @brief 数据合并引擎
+ *
+ * 将文本、条形码和二维码元素中形如 {{列名}} 的占位符绑定到数据列。
+ * 绑定时预先解析模板，之后每条记录只更新被绑定的元素，
+ * 从而可以一次加载模板、连续输出任意多张标签。
+ *
+ * 条形码的合并结果用BarcodeDataValidator按元素的类型验证，
+ * 无效的记录不会写入任何元素，由调用者决定终止还是跳过。
+ */
+class DataMergeEngine
+{
+public:
+    /**
+     * @brief 记录错误
+     */
+    struct RecordError {
+        int record;             ///< 记录序号（从0开始）
+        QString errorString;    ///< 错误说明
+    };
+
+    /**
+     * @brief 构造函数
+     * @param document 模板文档
+     */
+    explicit DataMergeEngine(LabelDocument *document = nullptr);
+
+    /**
+     * @brief 绑定模板文档
+     *
+     * 扫描文档中的元素并记录含占位符的模板
+     *
+     * @param document 模板文档
+     */
+    void bind(LabelDocument *document);
+
+    /**
+     * @brief 设置数据列名
+     *
+     * 将模板中的字段名解析为列索引
+     *
+     * @param columns 列名列表
+     */
+    void setColumns(const QStringList &columns);
+
+    /**
+     * @brief 获取被绑定的元素
+     * @return 元素列表
+     */
+    QList<LabelItem*> boundItems() const;
+
+    /**
+     * @brief 获取模板中引用的字段名
+     * @return 字段名列表
+     */
+    QStringList fields() const;
+
+    /**
+     * @brief 获取模板引用但数据中不存在的列
+     * @return 列名列表
+     */
+    QStringList missingColumns() const;
+
+    /**
+     * @brief 将一条记录应用到文档
+     *
+     * 先合并、验证并试编码全部绑定的内容，有条形码值无效时不修改任何元素，
+     * 避免标签沿用上一条记录的条形码；写入时元素仍然拒绝则恢复全部元素。
+     * EAN/UPC/ITF-14的值按验证器补全或修正校验位后写入
+     *
+     * @param record 记录字段值，顺序与setColumns()一致
+     * @param errorString 非空时输出失败原因
+     * @return 记录是否有效并已应用
+     */
+    bool apply(const QStringList &record, QString *errorString = nullptr);
+
+    /**
+     * @brief 批量验证记录
+     *
+     * 按条形码绑定整列验证，用于在渲染前一次检查一批记录
+     *
+     * @param records 记录列表
+     * @return 无效的记录，按序号排序，每条记录只报告第一个错误
+     */
+    QVector<RecordError> validate(const QList<QStringList> &records) const;
+
+    /**
+     * @brief 恢复元素的模板内容
+     */
+    void restore();
+
+    /**
+     * @brief 判断文本是否包含占位符
+     * @param text 文本
+     * @return 是否包含占位符
+     */
+    static bool hasPlaceholders(const QString &text);
+
+private:
+    /**
+     * @brief 模板片段
+     *
+     * field为空时表示文字片段，否则表示字段引用
+     */
+    struct Segment {
+        QString literal;    ///< 文字内容
+        QString field;      ///< 字段名
+        int column;         ///< 解析后的列索引，-1表示未找到
+    };
+
+    /**
+     * @brief 元素绑定
+     */
+    struct Binding {
+        LabelItem *item;            ///< 被绑定的元素
+        QString templateText;       ///< 原始模板
+        QVector<Segment> segments;  ///< 解析后的模板片段
+        std::shared_ptr<const BarcodeDataValidator> validator; ///< 条形码数据验证器，其他元素为空
+    };
+
+    /**
+     * @brief 解析模板文本
+     * @param text 模板文本
+     * @return 模板片段
+     */
+    static QVector<Segment> parseTemplate(const QString &text);
+
+    /**
+     * @brief 用记录填充模板
+     * @param binding 元素绑定
+     * @param record 记录字段值
+     * @return 合并后的内容
+     */
+    static QString mergeText(const Binding &binding, const QStringList &record);
+
+    /**
+     * @brief 生成条形码值无效的说明
+     * @param binding 元素绑定
+     * @param value 合并后的值
+     * @param error 错误类型
+     * @return 说明文本
+     */
+    static QString invalidValueString(const Binding &binding, const QString &value,
+                                      BarcodeDataValidator::Error error);
+
+    /**
+     * @brief 试编码条形码值
+     *
+     * 与元素写入和渲染时的检查相同，在修改任何元素之前调用。
+     * 没有专用内置编码器的类型要求ZXing编码成功，不接受按Code 128回退的结果
+     *
+     * @param binding 元素绑定
+     * @param value 合并后的值
+     * @return 非条形码元素或可以编码时返回true
+     */
+    static bool canEncode(const Binding &binding, const QString &value);
+
+    /**
+     * @brief 读取元素的可绑定内容
+     * @param item 元素
+     * @param text 输出的内容
+     * @return 元素是否支持绑定
+     */
+    static bool itemContent(const LabelItem *item, QString *text);
+
+    /**
+     * @brief 设置元素的可绑定内容
+     * @param item 元素
+     * @param text 新内容
+     */
+    static void setItemContent(LabelItem *item, const QString &text);
+
+    LabelDocument *m_document;      ///< 模板文档
+    QList<Binding> m_bindings;      ///< 元素绑定列表
+    QStringList m_columns;          ///< 数据列名
+};
+
+#endif // DATAMERGE_H
@@ -4,16 +4,20 @@
 #include "../items/imageitem.h"
 #include "../items/barcodeitem.h"
 #include "../items/qrcodeitem.h"
+#include "../render/renderplan.h"
 
 #include <QGraphicsScene>
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QDomDocument>
 #include <QFile>
 #include <QPageLayout>
+#include <QPageSize>
 #include <QPrinter>
 #include <QPainter>
 #include <QJsonArray>
 #include <QUndoStack>
+#include <QStyleOptionGraphicsItem>
 
 // ================= LabelDocument 类实现 =================
 
@@ -50,6 +54,11 @@ void LabelDocument::addItem(LabelItem *item)
     // 添加到列表
     m_items.append(item);
 
+    // 条形码按文档分辨率对齐打印点
+    if (BarcodeItem *barcode = qobject_cast<BarcodeItem*>(item)) {
+        barcode->setTargetDpi(m_dpi);
+    }
+
     // 如果有场景，添加到场景
     if (m_scene) {
         m_scene->addItem(item);
@@ -338,15 +347,123 @@ bool LabelDocument::fromJson(const QJsonObject &json)
     return true;
 }
 
-void LabelDocument::render(QPainter *painter, const QRectF &rect) const
+/**
+ * @brief 计算元素在页面坐标中的外接矩形（含旋转）
+ * @param item 元素
+ * @return 外接矩形
+ */
+static QRectF itemPageBounds(const LabelItem *item)
+{
+    QRectF bounds(item->position(), item->size());
+    if (!qFuzzyIsNull(item->rotation())) {
+        QTransform transform;
+        transform.translate(bounds.center().x(), bounds.center().y());
+        transform.rotate(item->rotation());
+        transform.translate(-bounds.center().x(), -bounds.center().y());
+        bounds = transform.mapRect(bounds);
+    }
+    return bounds;
+}
+
+/**
+ * @brief 计算渲染区域内可见的页面区域
+ * @param contentRect 页面内容区域
+ * @param transform 页面坐标到渲染区域的变换
+ * @param rect 渲染区域
+ * @return 内容区域与渲染区域的交集（页面坐标）
+ */
+static QRectF visiblePageRect(const QRectF &contentRect, const QTransform &transform, const QRectF &rect)
+{
+    QRectF visibleRect = contentRect;
+    bool invertible = false;
+    QTransform inverse = transform.inverted(&invertible);
+    if (invertible) {
+        visibleRect &= inverse.mapRect(rect);
+    }
+    return visibleRect;
+}
+
+/**
+ * @brief 判断元素是否需要绘制
+ *
+ * render()、compileRenderPlan()和isItemRendered()共用，保证各种输出路径剔除相同的元素
+ *
+ * @param item 元素
+ * @param visibleRect 可见区域（页面坐标）
+ * @return 元素可见且与可见区域相交时返回true
+ */
+static bool itemIntersects(const LabelItem *item, const QRectF &visibleRect)
+{
+    return item->isVisible() && visibleRect.intersects(itemPageBounds(item));
+}
+
+bool LabelDocument::isItemRendered(const LabelItem *item) const
+{
+    return item && itemIntersects(item, contentRect());
+}
+
+void LabelDocument::render(QPainter *painter, const QRectF &rect, RenderStats *stats) const
 {
     if (!painter) {
         return;
     }
 
+    QElapsedTimer timer;
+    timer.start();
+
+    int painted = 0;
+    int culled = 0;
+
     // 保存画家状态
     painter->save();
 
+    // 填充背景
+    painter->fillRect(rect, Qt::white);
+
+    // 设置变换
+    QTransform transform = pageTransform(rect);
+    painter->setTransform(transform, true);
+
+    // 可见区域：页面内容区域、渲染区域和当前裁剪区域的交集（页面坐标）
+    QRectF visibleRect = visiblePageRect(contentRect(), transform, rect);
+    if (painter->hasClipping()) {
+        visibleRect &= painter->clipBoundingRect();
+    }
+
+    // 输出时不绘制选中效果和控制点
+    QStyleOptionGraphicsItem option;
+    option.state = QStyle::State_None;
+
+    // 绘制元素
+    for (const LabelItem *item : m_items) {
+        if (!item->isVisible()) {
+            continue;
+        }
+
+        if (!itemIntersects(item, visibleRect)) {
+            ++culled;
+            continue;
+        }
+
+        // 同一设备只能有一个活动画家，直接使用当前画家绘制
+        painter->save();
+        const_cast<LabelItem*>(item)->paint(painter, &option, nullptr);
+        painter->restore();
+        ++painted;
+    }
+
+    // 恢复画家状态
+    painter->restore();
+
+    if (stats) {
+        stats->itemsPainted = painted;
+        stats->itemsCulled = culled;
+        stats->elapsedNs = timer.nsecsElapsed();
+    }
+}
+
+QTransform LabelDocument::pageTransform(const QRectF &rect) const
+{
     // 计算缩放因子
     QSizeF pageSize = pageRealSize();
     qreal scaleX = rect.width() / pageSize.width();
@@ -357,28 +474,86 @@ void LabelDocument::render(QPainter *painter, const QRectF &rect) const
     QRectF targetRect(rect.x(), rect.y(), pageSize.width() * scale, pageSize.height() * scale);
     targetRect.moveCenter(rect.center());
 
-    // 填充背景
-    painter->fillRect(rect, Qt::white);
+    QTransform transform;
+    transform.translate(targetRect.left(), targetRect.top());
+    transform.scale(scale, scale);
+    return transform;
+}
 
-    // 设置变换
-    painter->translate(targetRect.topLeft());
-    painter->scale(scale, scale);
+RenderPlan LabelDocument::compileRenderPlan(const QSize &size, const QList<LabelItem*> &dynamicItems) const
+{
+    RenderPlan plan;
+    if (size.isEmpty()) {
+        return plan;
+    }
 
-    // 绘制元素
-    for (const LabelItem *item : m_items) {
-        if (item->isVisible()) {
-            // 创建临时画家用于绘制元素
-            QPainter itemPainter(painter->device());
-            itemPainter.setRenderHints(painter->renderHints());
-            itemPainter.setTransform(painter->transform());
-
-            // 绘制元素
-            const_cast<LabelItem*>(item)->paint(&itemPainter, nullptr, nullptr);
+    const QRectF rect(0, 0, size.width(), size.height());
+    plan.m_transform = pageTransform(rect);
+
+    // 只保留可见元素（与render()剔除相同的元素），按绘制顺序找出第一个和最后一个动态元素
+    const QRectF visibleRect = visiblePageRect(contentRect(), plan.m_transform, rect);
+    QList<LabelItem*> visibleItems;
+    int firstDynamic = -1;
+    int lastDynamic = -1;
+    for (LabelItem *item : m_items) {
+        if (!itemIntersects(item, visibleRect)) {
+            continue;
+        }
+        if (dynamicItems.contains(item)) {
+            if (firstDynamic < 0) {
+                firstDynamic = visibleItems.size();
+            }
+            lastDynamic = visibleItems.size();
         }
+        visibleItems.append(item);
     }
 
-    // 恢复画家状态
-    painter->restore();
+    // 没有动态元素时整张标签都是静态的
+    if (firstDynamic < 0) {
+        firstDynamic = visibleItems.size();
+        lastDynamic = visibleItems.size() - 1;
+    }
+
+    QStyleOptionGraphicsItem option;
+    option.state = QStyle::State_None;
+
+    // 底层：白色背景和第一个动态元素之下的静态元素
+    plan.m_baseLayer = QImage(size, QImage::Format_ARGB32_Premultiplied);
+    plan.m_baseLayer.fill(Qt::white);
+    {
+        QPainter painter(&plan.m_baseLayer);
+        painter.setRenderHints(plan.m_renderHints);
+        painter.setTransform(plan.m_transform);
+        for (int i = 0; i < firstDynamic; ++i) {
+            painter.save();
+            visibleItems.at(i)->paint(&painter, &option, nullptr);
+            painter.restore();
+        }
+    }
+
+    // 中间部分每次实时绘制
+    for (int i = firstDynamic; i <= lastDynamic; ++i) {
+        plan.m_liveItems.append(visibleItems.at(i));
+    }
+
+    // 顶层：最后一个动态元素之上的静态元素
+    if (lastDynamic + 1 < visibleItems.size()) {
+        plan.m_overlayLayer = QImage(size, QImage::Format_ARGB32_Premultiplied);
+        plan.m_overlayLayer.fill(Qt::transparent);
+
+        QPainter painter(&plan.m_overlayLayer);
+        painter.setRenderHints(plan.m_renderHints);
+        painter.setTransform(plan.m_transform);
+        for (int i = lastDynamic + 1; i < visibleItems.size(); ++i) {
+            painter.save();
+            visibleItems.at(i)->paint(&painter, &option, nullptr);
+            painter.restore();
+        }
+    }
+
+    plan.m_staticItemCount = visibleItems.size() - plan.m_liveItems.size();
+
+    return plan;
 }
 
 QImage LabelDocument::toImage(const QSize &size) const
@@ -491,6 +666,13 @@ void LabelDocument::setDpi(int dpi)
     }
 
     m_dpi = dpi;
+
+    for (LabelItem *item : m_items) {
+        if (BarcodeItem *barcode = qobject_cast<BarcodeItem*>(item)) {
+            barcode->setTargetDpi(dpi);
+        }
+    }
+
     setModified();
     emit dpiChanged(dpi);
 }
@@ -523,11 +705,8 @@ QSizeF LabelDocument::pageRealSize() const
         return m_customSize;
     }
 
-    // 获取标准页面大小（以毫米为单位）
-    QPrinter printer;
-    printer.setPageSize(m_pageSize);
-    QPageLayout layout = printer.pageLayout();
-    QSizeF size = layout.pageSize().size(QPageSize::Millimeter);
+    // 获取标准页面大小（以毫米为单位），每次渲染都会调用，不创建QPrinter
+    QSizeF size = QPageSize(static_cast<QPageSize::PageSizeId>(m_pageSize)).size(QPageSize::Millimeter);
 
     // 根据方向调整
     if (m_orientation == QPageLayout::Landscape && size.width() < size.height()) {
@@ -10,9 +10,21 @@
 #include <QDomDocument>
 #include <QJsonObject>
 #include <QPainter>
+#include <QTransform>
 
 class LabelItem;
 class QGraphicsScene;
+class RenderPlan;
+
+/**
+ * @brief 渲染统计信息
+ */
+struct RenderStats
+{
+    int itemsPainted = 0;   ///< 绘制的元素数量
+    int itemsCulled = 0;    ///< 完全位于可见区域外而被跳过的元素数量
+    qint64 elapsedNs = 0;   ///< 渲染耗时（纳秒）
+};
 
 /**
  * @brief 标签文档类
@@ -120,10 +132,25 @@ public:
 
     /**
      * @brief 渲染文档
+     *
+     * 所有元素共用传入的画家绘制，完全位于渲染区域、页面内容区域
+     * 或当前裁剪区域之外的元素会被跳过
+     *
      * @param painter 绘图设备
      * @param rect 渲染区域
+     * @param stats 渲染统计信息，可为nullptr
+     */
+    void render(QPainter *painter, const QRectF &rect, RenderStats *stats = nullptr) const;
+
+    /**
+     * @brief 判断元素是否会被输出
+     *
+     * 元素可见且与页面内容区域相交；render()、compileRenderPlan()和ZPL导出剔除相同的元素
+     *
+     * @param item 元素
+     * @return 是否会被输出
      */
-    void render(QPainter *painter, const QRectF &rect) const;
+    bool isItemRendered(const LabelItem *item) const;
 
     /**
      * @brief 导出为图像
@@ -132,6 +159,28 @@ public:
      */
     QImage toImage(const QSize &size) const;
 
+    /**
+     * @brief 计算页面坐标到渲染区域的变换
+     *
+     * 页面按比例缩放并居中放入渲染区域
+     *
+     * @param rect 渲染区域
+     * @return 坐标变换
+     */
+    QTransform pageTransform(const QRectF &rect) const;
+
+    /**
+     * @brief 编译渲染计划
+     *
+     * 将不在动态元素列表中的元素预先光栅化，之后每次渲染只需绘制动态元素。
+     * 动态元素通常为DataMergeEngine::boundItems()。
+     *
+     * @param size 输出图像大小
+     * @param dynamicItems 每次渲染内容可能变化的元素
+     * @return 渲染计划
+     */
+    RenderPlan compileRenderPlan(const QSize &size, const QList<LabelItem*> &dynamicItems) const;
+
     /**
      * @brief 设置关联的场景
      * @param scene 图形场景
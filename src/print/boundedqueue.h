@@ -0,0 +1,126 @@
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QQueue>
+#include <QWaitCondition>
+
+/**
+ * @brief 有界阻塞队列
+ *
+ * 用于流水线各阶段之间传递数据。队列满时push()阻塞生产者（背压），
+ * 队列空时pop()阻塞消费者。close()之后push()失败，
+ * pop()取完剩余元素后返回false。
+ */
+template <typename T>
+class BoundedQueue
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param capacity 容量
+     */
+    explicit BoundedQueue(int capacity)
+        : m_capacity(qMax(1, capacity))
+        , m_closed(false)
+    {
+    }
+
+    /**
+     * @brief 放入元素，队列满时等待
+     * @param value 元素
+     * @return 队列已关闭时返回false
+     */
+    bool push(const T &value)
+    {
+        QMutexLocker locker(&m_mutex);
+        while (m_queue.size() >= m_capacity && !m_closed) {
+            m_notFull.wait(&m_mutex);
+        }
+        if (m_closed) {
+            return false;
+        }
+
+        m_queue.enqueue(value);
+        m_notEmpty.wakeOne();
+        return true;
+    }
+
+    /**
+     * @brief 尝试放入元素，不等待
+     * @param value 元素
+     * @return 队列已满或已关闭时返回false
+     */
+    bool tryPush(const T &value)
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_closed || m_queue.size() >= m_capacity) {
+            return false;
+        }
+
+        m_queue.enqueue(value);
+        m_notEmpty.wakeOne();
+        return true;
+    }
+
+    /**
+     * @brief 取出元素，队列空时等待
+     * @param value 输出元素
+     * @return 队列已关闭且为空时返回false
+     */
+    bool pop(T *value)
+    {
+        QMutexLocker locker(&m_mutex);
+        while (m_queue.isEmpty() && !m_closed) {
+            m_notEmpty.wait(&m_mutex);
+        }
+        if (m_queue.isEmpty()) {
+            return false;
+        }
+
+        *value = m_queue.dequeue();
+        m_notFull.wakeOne();
+        return true;
+    }
+
+    /**
+     * @brief 关闭队列并唤醒所有等待的线程
+     */
+    void close()
+    {
+        QMutexLocker locker(&m_mutex);
+        m_closed = true;
+        m_notFull.wakeAll();
+        m_notEmpty.wakeAll();
+    }
+
+    /**
+     * @brief 获取当前元素数量
+     * @return 元素数量
+     */
+    int size() const
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_queue.size();
+    }
+
+    /**
+     * @brief 获取容量
+     * @return 容量
+     */
+    int capacity() const
+    {
+        return m_capacity;
+    }
+
+private:
+    mutable QMutex m_mutex;         ///< 互斥锁
+    QWaitCondition m_notFull;       ///< 队列未满条件
+    QWaitCondition m_notEmpty;      ///< 队列非空条件
+    QQueue<T> m_queue;              ///< 元素队列
+    const int m_capacity;           ///< 容量
+    bool m_closed;                  ///< 是否已关闭
+};
+
+#endif // BOUNDEDQUEUE_H
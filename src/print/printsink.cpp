@@ -0,0 +1,344 @@
+#include "printsink.h"
+
+#include <QFile>
+#include <QPainter>
+#include <QPrinter>
+#include <QTcpSocket>
+#include <QThread>
+#include <QDebug>
+
+// ================= PrintSink 类实现 =================
+
+PrintSink::~PrintSink()
+{
+}
+
+bool PrintSink::acceptsImages() const
+{
+    return false;
+}
+
+bool PrintSink::acceptsPictures() const
+{
+    return false;
+}
+
+bool PrintSink::sendPicture(const QPicture &picture)
+{
+    Q_UNUSED(picture)
+
+    m_errorString = QStringLiteral("输出端不接收矢量图元");
+    return false;
+}
+
+QString PrintSink::errorString() const
+{
+    return m_errorString;
+}
+
+// ================= FilePrintSink 类实现 =================
+
+FilePrintSink::FilePrintSink(const QString &fileName, bool append)
+    : m_fileName(fileName)
+    , m_append(append)
+    , m_file(nullptr)
+{
+}
+
+FilePrintSink::~FilePrintSink()
+{
+    close();
+}
+
+bool FilePrintSink::open()
+{
+    close();
+
+    m_file = new QFile(m_fileName);
+    QIODevice::OpenMode mode = QIODevice::WriteOnly | (m_append ? QIODevice::Append : QIODevice::Truncate);
+    if (!m_file->open(mode)) {
+        m_errorString = m_file->errorString();
+        delete m_file;
+        m_file = nullptr;
+        return false;
+    }
+
+    // 同一假脱机的后续任务追加到末尾
+    m_append = true;
+    return true;
+}
+
+bool FilePrintSink::send(const QByteArray &data, const QImage &image)
+{
+    Q_UNUSED(image)
+
+    if (!m_file || m_file->write(data) != data.size()) {
+        m_errorString = m_file ? m_file->errorString() : QStringLiteral("文件未打开");
+        return false;
+    }
+
+    return true;
+}
+
+void FilePrintSink::close()
+{
+    if (m_file) {
+        m_file->close();
+        delete m_file;
+        m_file = nullptr;
+    }
+}
+
+// ================= TcpPrintSink 类实现 =================
+
+TcpPrintSink::TcpPrintSink(const QString &host, quint16 port, int timeout)
+    : m_host(host)
+    , m_port(port)
+    , m_timeout(timeout)
+    , m_socket(nullptr)
+{
+}
+
+TcpPrintSink::~TcpPrintSink()
+{
+    close();
+}
+
+bool TcpPrintSink::open()
+{
+    close();
+
+    // 套接字属于创建它的线程，因此在发送线程中创建
+    m_socket = new QTcpSocket();
+    m_socket->connectToHost(m_host, m_port);
+    if (!m_socket->waitForConnected(m_timeout)) {
+        m_errorString = m_socket->errorString();
+        delete m_socket;
+        m_socket = nullptr;
+        return false;
+    }
+
+    return true;
+}
+
+bool TcpPrintSink::send(const QByteArray &data, const QImage &image)
+{
+    Q_UNUSED(image)
+
+    if (!m_socket) {
+        m_errorString = QStringLiteral("未连接打印机");
+        return false;
+    }
+
+    if (m_socket->write(data) != data.size()) {
+        m_errorString = m_socket->errorString();
+        return false;
+    }
+
+    // 等待写入内核缓冲区，由TCP窗口向假脱机施加背压
+    while (m_socket->bytesToWrite() > 0) {
+        if (!m_socket->waitForBytesWritten(m_timeout)) {
+            m_errorString = m_socket->errorString();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void TcpPrintSink::close()
+{
+    if (m_socket) {
+        m_socket->disconnectFromHost();
+        if (m_socket->state() != QAbstractSocket::UnconnectedState) {
+            m_socket->waitForDisconnected(m_timeout);
+        }
+        delete m_socket;
+        m_socket = nullptr;
+    }
+}
+
+// ================= PrinterPrintSink 类实现 =================
+
+PrinterPrintSink::PrinterPrintSink(QPrinter *printer)
+    : m_printer(printer)
+    , m_painter(nullptr)
+    , m_firstPage(true)
+{
+}
+
+PrinterPrintSink::~PrinterPrintSink()
+{
+    close();
+}
+
+bool PrinterPrintSink::acceptsImages() const
+{
+    return true;
+}
+
+bool PrinterPrintSink::acceptsPictures() const
+{
+    return true;
+}
+
+bool PrinterPrintSink::open()
+{
+    close();
+
+    m_painter = new QPainter();
+    if (!m_painter->begin(m_printer)) {
+        m_errorString = QStringLiteral("无法启动打印");
+        delete m_painter;
+        m_painter = nullptr;
+        return false;
+    }
+
+    m_firstPage = true;
+    return true;
+}
+
+bool PrinterPrintSink::send(const QByteArray &data, const QImage &image)
+{
+    Q_UNUSED(data)
+
+    if (!beginPage()) {
+        return false;
+    }
+
+    // 图像按页面可打印区域等比缩放，画家原点即可打印区域左上角
+    QRectF pageRect = m_printer->pageRect(QPrinter::DevicePixel);
+    QSizeF size = QSizeF(image.size()).scaled(pageRect.size(), Qt::KeepAspectRatio);
+    QRectF target(QPointF(0, 0), size);
+    m_painter->drawImage(target, image);
+
+    return true;
+}
+
+bool PrinterPrintSink::sendPicture(const QPicture &picture)
+{
+    if (!beginPage()) {
+        return false;
+    }
+
+    const QRect bounds = picture.boundingRect();
+    if (bounds.isEmpty()) {
+        return true;
+    }
+
+    // 与图像相同，按页面可打印区域等比缩放
+    QRectF pageRect = m_printer->pageRect(QPrinter::DevicePixel);
+    QSizeF size = QSizeF(bounds.size()).scaled(pageRect.size(), Qt::KeepAspectRatio);
+
+    m_painter->save();
+    m_painter->scale(size.width() / bounds.width(), size.height() / bounds.height());
+    m_painter->drawPicture(0, 0, picture);
+    m_painter->restore();
+
+    return true;
+}
+
+bool PrinterPrintSink::beginPage()
+{
+    if (!m_painter) {
+        m_errorString = QStringLiteral("打印未启动");
+        return false;
+    }
+
+    if (!m_firstPage && !m_printer->newPage()) {
+        m_errorString = QStringLiteral("无法新建页面");
+        return false;
+    }
+    m_firstPage = false;
+
+    return true;
+}
+
+void PrinterPrintSink::close()
+{
+    if (m_painter) {
+        m_painter->end();
+        delete m_painter;
+        m_painter = nullptr;
+    }
+}
+
+// ================= SimulatedPrintSink 类实现 =================
+
+SimulatedPrintSink::SimulatedPrintSink(double labelsPerSecond, qint64 bytesPerSecond)
+    : m_labelsPerSecond(labelsPerSecond)
+    , m_bytesPerSecond(bytesPerSecond)
+    , m_labelCount(0)
+    , m_idleTime(0)
+{
+}
+
+bool SimulatedPrintSink::open()
+{
+    QMutexLocker locker(&m_mutex);
+    m_lastLabel.invalidate();
+    return true;
+}
+
+bool SimulatedPrintSink::send(const QByteArray &data, const QImage &image)
+{
+    Q_UNUSED(image)
+
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_lastLabel.isValid()) {
+            m_idleTime += m_lastLabel.elapsed();
+        }
+        m_data += data;
+        ++m_labelCount;
+    }
+
+    // 传输和打印取较慢的一个
+    qint64 delay = 0;
+    if (m_bytesPerSecond > 0) {
+        delay = data.size() * 1000 / m_bytesPerSecond;
+    }
+    if (m_labelsPerSecond > 0) {
+        delay = qMax(delay, static_cast<qint64>(1000.0 / m_labelsPerSecond));
+    }
+    if (delay > 0) {
+        QThread::msleep(static_cast<unsigned long>(delay));
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_lastLabel.start();
+    return true;
+}
+
+void SimulatedPrintSink::close()
+{
+    QMutexLocker locker(&m_mutex);
+    m_lastLabel.invalidate();
+}
+
+QByteArray SimulatedPrintSink::receivedData() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_data;
+}
+
+int SimulatedPrintSink::labelCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_labelCount;
+}
+
+qint64 SimulatedPrintSink::idleTime() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_idleTime;
+}
+
+void SimulatedPrintSink::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_data.clear();
+    m_labelCount = 0;
+    m_idleTime = 0;
+    m_lastLabel.invalidate();
+}
@@ -0,0 +1,238 @@
+#ifndef PRINTSINK_H
+#define PRINTSINK_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QMutex>
+#include <QPicture>
+#include <QString>
+
+class QFile;
+class QPainter;
+class QPrinter;
+class QTcpSocket;
+
+/**
+ * @brief 打印输出端
+ *
+ * 打印假脱机的最后一级。open()、send()和close()都在假脱机的
+ * 发送线程中调用，每个打印任务调用一次open()和close()；
+ * 没有标签要发送的任务（已取消或渲染失败）不打开输出端。
+ */
+class PrintSink
+{
+public:
+    /**
+     * @brief 析构函数
+     */
+    virtual ~PrintSink();
+
+    /**
+     * @brief 是否直接接收渲染图像
+     *
+     * 返回true时假脱机跳过编码阶段，send()的data为空
+     *
+     * @return 是否接收图像
+     */
+    virtual bool acceptsImages() const;
+
+    /**
+     * @brief 是否接收矢量图元
+     *
+     * 返回true时假脱机把每张标签录制为QPicture，不光栅化也不编码，
+     * 通过sendPicture()发送。优先于acceptsImages()
+     *
+     * @return 是否接收矢量图元
+     */
+    virtual bool acceptsPictures() const;
+
+    /**
+     * @brief 打开输出端
+     * @return 是否成功
+     */
+    virtual bool open() = 0;
+
+    /**
+     * @brief 发送一张标签
+     * @param data 编码后的打印机指令
+     * @param image 渲染图像（acceptsImages()为true时有效）
+     * @return 是否成功
+     */
+    virtual bool send(const QByteArray &data, const QImage &image) = 0;
+
+    /**
+     * @brief 发送一张矢量标签
+     *
+     * 只在acceptsPictures()为true时调用
+     *
+     * @param picture 标签图元，boundingRect()为整个页面（打印点）
+     * @return 是否成功
+     */
+    virtual bool sendPicture(const QPicture &picture);
+
+    /**
+     * @brief 关闭输出端
+     */
+    virtual void close() = 0;
+
+    /**
+     * @brief 获取最近一次错误的描述
+     * @return 错误描述
+     */
+    QString errorString() const;
+
+protected:
+    QString m_errorString;      ///< 错误描述
+};
+
+/**
+ * @brief 文件输出端
+ *
+ * 将打印机指令追加写入本地文件或设备文件（如/dev/usb/lp0）
+ */
+class FilePrintSink : public PrintSink
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param fileName 文件路径
+     * @param append 是否追加到已有文件末尾
+     */
+    explicit FilePrintSink(const QString &fileName, bool append = false);
+    ~FilePrintSink() override;
+
+    // PrintSink 接口实现
+    bool open() override;
+    bool send(const QByteArray &data, const QImage &image) override;
+    void close() override;
+
+private:
+    QString m_fileName;     ///< 文件路径
+    bool m_append;          ///< 是否追加
+    QFile *m_file;          ///< 打开的文件
+};
+
+/**
+ * @brief 原始TCP输出端
+ *
+ * 连接打印机的原始打印端口（通常为9100）直接发送指令
+ */
+class TcpPrintSink : public PrintSink
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param host 打印机地址
+     * @param port 端口
+     * @param timeout 连接和发送超时（毫秒）
+     */
+    TcpPrintSink(const QString &host, quint16 port = 9100, int timeout = 10000);
+    ~TcpPrintSink() override;
+
+    // PrintSink 接口实现
+    bool open() override;
+    bool send(const QByteArray &data, const QImage &image) override;
+    void close() override;
+
+private:
+    QString m_host;         ///< 打印机地址
+    quint16 m_port;         ///< 端口
+    int m_timeout;          ///< 超时
+    QTcpSocket *m_socket;   ///< 连接（在发送线程中创建）
+};
+
+/**
+ * @brief 系统打印机输出端
+ *
+ * 通过QPrinter打印，每张标签一页。标签以矢量图元重放到打印机，
+ * 文字、条码和二维码保持矢量输出，也不必在队列中缓存整页位图
+ */
+class PrinterPrintSink : public PrintSink
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param printer 打印机（调用方持有，打印期间不能修改）
+     */
+    explicit PrinterPrintSink(QPrinter *printer);
+    ~PrinterPrintSink() override;
+
+    // PrintSink 接口实现
+    bool acceptsImages() const override;
+    bool acceptsPictures() const override;
+    bool open() override;
+    bool send(const QByteArray &data, const QImage &image) override;
+    bool sendPicture(const QPicture &picture) override;
+    void close() override;
+
+private:
+    /**
+     * @brief 开始新的一页
+     * @return 是否成功
+     */
+    bool beginPage();
+
+    QPrinter *m_printer;    ///< 打印机
+    QPainter *m_painter;    ///< 当前任务的画家
+    bool m_firstPage;       ///< 是否为任务的第一页
+};
+
+/**
+ * @brief 模拟打印机输出端
+ *
+ * 用于测试：记录收到的全部字节，并按设定的打印速度和链路带宽延时，
+ * 以便观察流水线是否会让打印机空等
+ */
+class SimulatedPrintSink : public PrintSink
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param labelsPerSecond 打印速度（张/秒），0表示不限
+     * @param bytesPerSecond 链路带宽（字节/秒），0表示不限
+     */
+    explicit SimulatedPrintSink(double labelsPerSecond = 0, qint64 bytesPerSecond = 0);
+
+    // PrintSink 接口实现
+    bool open() override;
+    bool send(const QByteArray &data, const QImage &image) override;
+    void close() override;
+
+    /**
+     * @brief 获取收到的全部字节
+     * @return 字节数据
+     */
+    QByteArray receivedData() const;
+
+    /**
+     * @brief 获取已打印的标签数
+     * @return 标签数
+     */
+    int labelCount() const;
+
+    /**
+     * @brief 获取打印机空等的累计时间
+     *
+     * 即同一任务中上一张标签打印完成到下一张标签到达之间的时间
+     *
+     * @return 空等时间（毫秒）
+     */
+    qint64 idleTime() const;
+
+    /**
+     * @brief 清空记录
+     */
+    void clear();
+
+private:
+    double m_labelsPerSecond;   ///< 打印速度
+    qint64 m_bytesPerSecond;    ///< 链路带宽
+    mutable QMutex m_mutex;     ///< 保护记录数据
+    QByteArray m_data;          ///< 收到的字节
+    int m_labelCount;           ///< 已打印的标签数
+    qint64 m_idleTime;          ///< 累计空等时间
+    QElapsedTimer m_lastLabel;  ///< 上一张标签打印完成的时刻
+};
+
+#endif // PRINTSINK_H
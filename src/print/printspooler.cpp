@@ -0,0 +1,347 @@
+#include "printspooler.h"
+#include "printsink.h"
+#include "zplgraphicencoder.h"
+#include "../models/labelmodels.h"
+#include "../models/datamerge.h"
+#include "../render/monorenderer.h"
+#include "../render/renderplan.h"
+
+#include <QDeadlineTimer>
+#include <QPainter>
+#include <QThread>
+#include <QDebug>
+
+// 毫米与英寸的换算
+static const qreal MM_PER_INCH = 25.4;
+
+// 任务队列的容量
+static const int JOB_QUEUE_CAPACITY = 64;
+
+// 位图输出端的阶段队列容量：600 dpi的A4整页ARGB32图像约139 MB，
+// 渲染一张、发送一张即可让打印机不空等
+static const int IMAGE_QUEUE_CAPACITY = 2;
+
+// 根据输出端接收的格式确定阶段队列容量
+static int stageCapacity(const PrintSink *sink, int capacity)
+{
+    if (sink->acceptsImages() && !sink->acceptsPictures()) {
+        return qBound(1, capacity, IMAGE_QUEUE_CAPACITY);
+    }
+    return qMax(1, capacity);
+}
+
+PrintSpooler::PrintSpooler(PrintSink *sink, int capacity, QObject *parent)
+    : QObject(parent)
+    , m_sink(sink)
+    , m_dpi(0)
+    , m_jobs(JOB_QUEUE_CAPACITY)
+    , m_rendered(stageCapacity(sink, capacity))
+    , m_encoded(stageCapacity(sink, capacity))
+    , m_nextJobId(1)
+    , m_generation(0)
+    , m_failedJob(-1)
+    , m_pendingJobs(0)
+{
+    m_renderThread = QThread::create([this]() { renderStage(); });
+    m_encodeThread = QThread::create([this]() { encodeStage(); });
+    m_sendThread = QThread::create([this]() { sendStage(); });
+
+    m_renderThread->start();
+    m_encodeThread->start();
+    m_sendThread->start();
+}
+
+PrintSpooler::~PrintSpooler()
+{
+    cancel();
+
+    // 按流水线顺序关闭，每个阶段处理完剩余数据后退出
+    m_jobs.close();
+    m_renderThread->wait();
+    m_rendered.close();
+    m_encodeThread->wait();
+    m_encoded.close();
+    m_sendThread->wait();
+
+    delete m_renderThread;
+    delete m_encodeThread;
+    delete m_sendThread;
+    delete m_sink;
+}
+
+void PrintSpooler::setResolution(int dpi)
+{
+    m_dpi = qMax(0, dpi);
+}
+
+int PrintSpooler::resolution() const
+{
+    return m_dpi;
+}
+
+int PrintSpooler::submit(const LabelDocument *document, int copies)
+{
+    SpoolJob job;
+    job.snapshot = document->toJson();
+    job.pageSize = document->pageRealSize();
+    job.dpi = m_dpi > 0 ? m_dpi : document->dpi();
+    job.copies = qMax(0, copies);
+    return enqueue(job);
+}
+
+int PrintSpooler::submit(const LabelDocument *document, const QStringList &columns, const QList<QStringList> &records)
+{
+    SpoolJob job;
+    job.snapshot = document->toJson();
+    job.pageSize = document->pageRealSize();
+    job.dpi = m_dpi > 0 ? m_dpi : document->dpi();
+    job.columns = columns;
+    job.records = records;
+    return enqueue(job);
+}
+
+int PrintSpooler::enqueue(SpoolJob job)
+{
+    job.id = m_nextJobId.fetchAndAddRelaxed(1);
+    job.generation = m_generation.loadAcquire();
+
+    {
+        QMutexLocker locker(&m_pendingMutex);
+        ++m_pendingJobs;
+    }
+
+    // 提交不阻塞调用线程（通常是界面线程）
+    if (!m_jobs.tryPush(job)) {
+        qWarning() << "打印任务队列已满";
+        finishJob();
+        return -1;
+    }
+
+    return job.id;
+}
+
+void PrintSpooler::cancel()
+{
+    m_generation.fetchAndAddRelease(1);
+}
+
+int PrintSpooler::pendingJobs() const
+{
+    QMutexLocker locker(&m_pendingMutex);
+    return m_pendingJobs;
+}
+
+bool PrintSpooler::waitForDone(int msecs)
+{
+    QDeadlineTimer deadline(msecs < 0 ? QDeadlineTimer(QDeadlineTimer::Forever) : QDeadlineTimer(msecs));
+
+    QMutexLocker locker(&m_pendingMutex);
+    while (m_pendingJobs > 0) {
+        if (!m_pendingCondition.wait(&m_pendingMutex, deadline)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool PrintSpooler::isStale(int jobId, int generation) const
+{
+    return generation != m_generation.loadAcquire() || jobId == m_failedJob.loadAcquire();
+}
+
+void PrintSpooler::finishJob()
+{
+    QMutexLocker locker(&m_pendingMutex);
+    --m_pendingJobs;
+    m_pendingCondition.wakeAll();
+}
+
+void PrintSpooler::renderStage()
+{
+    const bool vector = m_sink->acceptsPictures();
+    const bool encode = !vector && !m_sink->acceptsImages();
+
+    SpoolJob job;
+    while (m_jobs.pop(&job)) {
+        const int count = job.records.isEmpty() ? job.copies : job.records.size();
+        const QSize imageSize(qMax(1, qRound(job.pageSize.width() * job.dpi / MM_PER_INCH)),
+                              qMax(1, qRound(job.pageSize.height() * job.dpi / MM_PER_INCH)));
+        const int dotsPerMeter = qRound(job.dpi * 1000.0 / MM_PER_INCH);
+
+        // 已取消的任务不再加载快照，直接补结束标记
+        const bool stale = isStale(job.id, job.generation);
+
+        LabelDocument document;
+        const bool loaded = !stale && document.fromJson(job.snapshot);
+        bool lastPushed = false;
+        QString errorString;
+
+        if (loaded && count > 0) {
+            DataMergeEngine engine;
+            if (!job.records.isEmpty()) {
+                engine.bind(&document);
+                engine.setColumns(job.columns);
+            }
+
+            // 静态内容只光栅化一次（矢量输出不需要）
+            RenderPlan plan;
+            if (!vector) {
+                plan = document.compileRenderPlan(imageSize, engine.boundItems());
+            }
+
+            // 抖动区域只在编码为打印机指令时使用
+            QRegion ditherRegion;
+            if (encode) {
+                MonoRenderer monoRenderer(&document);
+                monoRenderer.setResolution(job.dpi);
+                ditherRegion = monoRenderer.ditherRegion();
+            }
+
+            for (int i = 0; i < count; ++i) {
+                if (isStale(job.id, job.generation)) {
+                    break;
+                }
+
+                // 无效记录终止任务，不能打印沿用上一条数据的标签
+                if (!job.records.isEmpty() && !engine.apply(job.records.at(i), &errorString)) {
+                    errorString = tr("第%1条记录无效：%2").arg(i + 1).arg(errorString);
+                    break;
+                }
+
+                SpoolLabel label;
+                label.jobId = job.id;
+                label.generation = job.generation;
+                label.index = i;
+                label.count = count;
+                label.last = (i == count - 1);
+                if (vector) {
+                    // 以打印点为单位录制，输出端按页面缩放
+                    QPainter painter(&label.picture);
+                    document.render(&painter, QRectF(QPointF(0, 0), imageSize));
+                    painter.end();
+                    label.picture.setBoundingRect(QRect(QPoint(0, 0), imageSize));
+                } else {
+                    label.image = plan.render();
+                    label.image.setDotsPerMeterX(dotsPerMeter);
+                    label.image.setDotsPerMeterY(dotsPerMeter);
+                    label.ditherRegion = ditherRegion;
+                }
+
+                // 下游队列满时在此阻塞
+                if (!m_rendered.push(label)) {
+                    return;
+                }
+                lastPushed = label.last;
+            }
+        } else if (!loaded && !stale) {
+            qWarning() << "打印任务" << job.id << "的文档快照无效";
+        }
+
+        // 提前结束的任务补一个结束标记，让发送阶段完成收尾
+        if (!lastPushed) {
+            SpoolLabel marker;
+            marker.jobId = job.id;
+            marker.generation = job.generation;
+            marker.count = count;
+            marker.last = true;
+            marker.marker = true;
+            marker.errorString = errorString;
+            if (!m_rendered.push(marker)) {
+                return;
+            }
+        }
+    }
+}
+
+void PrintSpooler::encodeStage()
+{
+    const bool encode = !m_sink->acceptsPictures() && !m_sink->acceptsImages();
+
+    SpoolLabel label;
+    while (m_rendered.pop(&label)) {
+        if (encode && !label.marker && !isStale(label.jobId, label.generation)) {
+            const QImage mono = MonoRenderer::toMono(label.image, 128, label.ditherRegion);
+
+            QByteArray zpl;
+            zpl += "^XA\n";
+            zpl += "^LH0,0\n";
+            zpl += "^PW" + QByteArray::number(mono.width()) + "\n";
+            zpl += "^LL" + QByteArray::number(mono.height()) + "\n";
+            zpl += "^FO0,0" + ZplGraphicEncoder::graphicField(mono) + "^FS\n";
+            zpl += "^XZ\n";
+
+            label.data = zpl;
+            label.image = QImage();
+        }
+
+        if (!m_encoded.push(label)) {
+            return;
+        }
+    }
+}
+
+void PrintSpooler::sendStage()
+{
+    int currentJob = -1;
+    bool jobOk = true;
+    bool opened = false;
+    QString errorString;
+
+    SpoolLabel label;
+    while (m_encoded.pop(&label)) {
+        if (label.jobId != currentJob) {
+            currentJob = label.jobId;
+            jobOk = true;
+            opened = false;
+            errorString.clear();
+        }
+
+        if (jobOk && label.generation != m_generation.loadAcquire()) {
+            jobOk = false;
+            errorString = tr("打印已取消");
+        }
+
+        // 第一张要发送的标签到达时才打开输出端，
+        // 已取消的任务和只有结束标记的任务不会向打印机提交空任务
+        if (jobOk && !label.marker && !opened) {
+            opened = m_sink->open();
+            if (!opened) {
+                jobOk = false;
+                errorString = m_sink->errorString();
+                m_failedJob.storeRelease(label.jobId);
+                m_sink->close();
+            }
+        }
+
+        if (jobOk && !label.marker) {
+            const bool sent = m_sink->acceptsPictures() ? m_sink->sendPicture(label.picture)
+                                                        : m_sink->send(label.data, label.image);
+            if (sent) {
+                emit labelPrinted(label.jobId, label.index, label.count);
+            } else {
+                jobOk = false;
+                errorString = m_sink->errorString();
+                m_failedJob.storeRelease(label.jobId);
+            }
+        }
+
+        if (label.last) {
+            // 提前结束的任务视为失败
+            if (jobOk && label.marker && !label.errorString.isEmpty()) {
+                jobOk = false;
+                errorString = label.errorString;
+            } else if (jobOk && label.marker && label.count > 0) {
+                jobOk = false;
+                errorString = tr("文档无法渲染");
+            }
+
+            if (opened) {
+                m_sink->close();
+            }
+            emit jobFinished(label.jobId, jobOk, errorString);
+            finishJob();
+            currentJob = -1;
+        }
+    }
+}
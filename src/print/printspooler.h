@@ -0,0 +1,205 @@
+#ifndef PRINTSPOOLER_H
+#define PRINTSPOOLER_H
+
+#include <QObject>
+#include <QAtomicInt>
+#include <QImage>
+#include <QJsonObject>
+#include <QList>
+#include <QMutex>
+#include <QPicture>
+#include <QRegion>
+#include <QSizeF>
+#include <QStringList>
+#include <QWaitCondition>
+
+#include "boundedqueue.h"
+
+class LabelDocument;
+class PrintSink;
+class QThread;
+
+/**
+ * @brief 流水线打印假脱机
+ *
+ * 打印任务分三个阶段在各自的线程中执行：
+ * 渲染（合并数据并光栅化）→ 编码（二值化并压缩为ZPL图形）→ 发送（写入输出端）。
+ * 阶段之间通过有界队列连接，不同标签的各阶段相互重叠，
+ * 发送当前标签时后续标签已在渲染和编码，长批次中打印机不会空等；
+ * 下游较慢时队列填满，上游阶段自动阻塞（背压），内存占用有上限。
+ * 输出端接收矢量图元时（系统打印机）标签只录制为QPicture，不经过光栅化和编码；
+ * 只接收整页位图的输出端队列深度限制为IMAGE_QUEUE_CAPACITY，避免缓存大量整页图像。
+ *
+ * 提交时保存文档快照，之后可以继续编辑文档。
+ * 信号在工作线程中发出，连接到界面对象时自动排队到界面线程。
+ */
+class PrintSpooler : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 构造函数
+     * @param sink 输出端（假脱机取得所有权）
+     * @param capacity 每个阶段队列可缓存的标签数（位图输出端最多IMAGE_QUEUE_CAPACITY）
+     * @param parent 父对象
+     */
+    explicit PrintSpooler(PrintSink *sink, int capacity = 8, QObject *parent = nullptr);
+
+    /**
+     * @brief 析构函数
+     *
+     * 取消未完成的任务并等待工作线程退出
+     */
+    ~PrintSpooler() override;
+
+    /**
+     * @brief 设置输出分辨率
+     * @param dpi 分辨率，0表示使用文档设置
+     */
+    void setResolution(int dpi);
+
+    /**
+     * @brief 获取输出分辨率
+     * @return 分辨率，0表示使用文档设置
+     */
+    int resolution() const;
+
+    /**
+     * @brief 提交打印任务
+     * @param document 文档（提交时保存快照）
+     * @param copies 份数
+     * @return 任务编号，任务队列已满时返回-1
+     */
+    int submit(const LabelDocument *document, int copies = 1);
+
+    /**
+     * @brief 提交数据合并打印任务
+     * @param document 模板文档（提交时保存快照）
+     * @param columns 数据列名
+     * @param records 记录列表，每条记录打印一张标签
+     * @return 任务编号，任务队列已满时返回-1
+     */
+    int submit(const LabelDocument *document, const QStringList &columns, const QList<QStringList> &records);
+
+    /**
+     * @brief 取消所有未完成的任务
+     */
+    void cancel();
+
+    /**
+     * @brief 获取未完成的任务数
+     * @return 任务数
+     */
+    int pendingJobs() const;
+
+    /**
+     * @brief 等待所有任务完成
+     * @param msecs 超时（毫秒），-1表示一直等待
+     * @return 是否全部完成
+     */
+    bool waitForDone(int msecs = -1);
+
+signals:
+    /**
+     * @brief 标签已发送信号
+     * @param jobId 任务编号
+     * @param index 标签序号（从0开始）
+     * @param count 任务的标签总数
+     */
+    void labelPrinted(int jobId, int index, int count);
+
+    /**
+     * @brief 任务完成信号
+     * @param jobId 任务编号
+     * @param success 是否全部成功
+     * @param errorString 失败原因
+     */
+    void jobFinished(int jobId, bool success, const QString &errorString);
+
+private:
+    /**
+     * @brief 打印任务
+     */
+    struct SpoolJob
+    {
+        int id = -1;                    ///< 任务编号
+        int generation = 0;             ///< 提交时的取消代数
+        QJsonObject snapshot;           ///< 文档快照
+        QSizeF pageSize;                ///< 页面尺寸（毫米）
+        int dpi = 0;                    ///< 输出分辨率
+        int copies = 0;                 ///< 份数（无记录时）
+        QStringList columns;            ///< 数据列名
+        QList<QStringList> records;     ///< 数据记录
+    };
+
+    /**
+     * @brief 流水线中的一张标签
+     */
+    struct SpoolLabel
+    {
+        int jobId = -1;                 ///< 任务编号
+        int generation = 0;             ///< 任务的取消代数
+        int index = 0;                  ///< 标签序号
+        int count = 0;                  ///< 任务的标签总数
+        bool last = false;              ///< 是否为任务的最后一项
+        bool marker = false;            ///< 仅用于结束任务的空标记
+        QImage image;                   ///< 渲染图像
+        QPicture picture;               ///< 矢量图元（输出端接收图元时）
+        QRegion ditherRegion;           ///< 需要抖动的区域
+        QByteArray data;                ///< 编码后的打印机指令
+        QString errorString;            ///< 任务提前结束的原因（仅结束标记）
+    };
+
+    /**
+     * @brief 将任务放入任务队列
+     * @param job 任务
+     * @return 任务编号，任务队列已满时返回-1
+     */
+    int enqueue(SpoolJob job);
+
+    /**
+     * @brief 判断任务是否已取消或已失败
+     * @param jobId 任务编号
+     * @param generation 任务的取消代数
+     * @return 是否应跳过
+     */
+    bool isStale(int jobId, int generation) const;
+
+    /**
+     * @brief 渲染阶段
+     */
+    void renderStage();
+
+    /**
+     * @brief 编码阶段
+     */
+    void encodeStage();
+
+    /**
+     * @brief 发送阶段
+     */
+    void sendStage();
+
+    /**
+     * @brief 任务结束时更新计数并唤醒等待者
+     */
+    void finishJob();
+
+    PrintSink *m_sink;                      ///< 输出端
+    int m_dpi;                              ///< 输出分辨率
+    BoundedQueue<SpoolJob> m_jobs;          ///< 待渲染的任务
+    BoundedQueue<SpoolLabel> m_rendered;    ///< 待编码的标签
+    BoundedQueue<SpoolLabel> m_encoded;     ///< 待发送的标签
+    QThread *m_renderThread;                ///< 渲染线程
+    QThread *m_encodeThread;                ///< 编码线程
+    QThread *m_sendThread;                  ///< 发送线程
+    QAtomicInt m_nextJobId;                 ///< 下一个任务编号
+    QAtomicInt m_generation;                ///< 取消代数，cancel()时递增
+    QAtomicInt m_failedJob;                 ///< 最近失败的任务编号
+    mutable QMutex m_pendingMutex;          ///< 保护未完成任务数
+    QWaitCondition m_pendingCondition;      ///< 任务完成条件
+    int m_pendingJobs;                      ///< 未完成的任务数
+};
+
+#endif // PRINTSPOOLER_H
@@ -0,0 +1,411 @@
+#include "zplexporter.h"
+#include "../models/labelmodels.h"
+#include "../items/labelitem.h"
+#include "../items/textitem.h"
+#include "../items/barcodeitem.h"
+#include "../items/qrcodeitem.h"
+#include "../render/monorenderer.h"
+#include "zplgraphicencoder.h"
+
+#include <QFile>
+#include <QFontMetricsF>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QDebug>
+
+// 毫米与英寸的换算
+static const qreal MM_PER_INCH = 25.4;
+
+// ^BY模块宽度和^BQ放大倍数的上限
+static const int MAX_MODULE_DOTS = 10;
+
+/**
+ * @brief 判断颜色能否作为打印点（深色且不透明）
+ */
+static bool isInk(const QColor &color)
+{
+    return color.alpha() >= 128 && qGray(color.rgb()) < 128;
+}
+
+/**
+ * @brief 判断颜色能否作为纸张（浅色或透明）
+ */
+static bool isPaper(const QColor &color)
+{
+    return color.alpha() < 128 || qGray(color.rgb()) >= 128;
+}
+
+/**
+ * @brief 转义字段数据
+ *
+ * 配合^FH使用，ZPL控制字符和非ASCII字节以_XX十六进制形式输出
+ *
+ * @param text 字段内容
+ * @param fieldBlock 是否位于^FB字段块中（换行转换为\&）
+ * @return 转义后的数据
+ */
+static QByteArray escapeFieldData(const QString &text, bool fieldBlock = false)
+{
+    static const char hexDigits[] = "0123456789ABCDEF";
+
+    const QByteArray utf8 = text.toUtf8();
+    QByteArray data;
+    data.reserve(utf8.size() + 16);
+
+    for (char ch : utf8) {
+        const uchar byte = static_cast<uchar>(ch);
+        if (fieldBlock && byte == '\n') {
+            data += "\\&";
+        } else if (fieldBlock && byte == '\\') {
+            data += "\\\\";
+        } else if (byte == '^' || byte == '~' || byte == '_' || byte < 0x20 || byte >= 0x7f) {
+            data += '_';
+            data += hexDigits[byte >> 4];
+            data += hexDigits[byte & 0x0f];
+        } else {
+            data += ch;
+        }
+    }
+
+    return data;
+}
+
+ZplExporter::ZplExporter(const LabelDocument *document)
+    : m_document(document)
+    , m_dpi(0)
+    , m_compression(ZplGraphicEncoder::Smallest)
+    , m_nativeFieldCount(0)
+    , m_graphicFieldCount(0)
+{
+    setResolution(document->dpi());
+}
+
+void ZplExporter::setResolution(int dpi)
+{
+    m_dpi = qMax(1, dpi);
+
+    QSizeF pageSize = m_document->pageRealSize();
+    m_labelSize = QSize(qMax(1, qRound(pageSize.width() * m_dpi / MM_PER_INCH)),
+                        qMax(1, qRound(pageSize.height() * m_dpi / MM_PER_INCH)));
+    m_transform = m_document->pageTransform(QRectF(QPointF(0, 0), m_labelSize));
+}
+
+int ZplExporter::resolution() const
+{
+    return m_dpi;
+}
+
+void ZplExporter::setCompression(ZplGraphicEncoder::Compression compression)
+{
+    m_compression = compression;
+}
+
+ZplGraphicEncoder::Compression ZplExporter::compression() const
+{
+    return m_compression;
+}
+
+QByteArray ZplExporter::exportLabel()
+{
+    m_nativeFieldCount = 0;
+    m_graphicFieldCount = 0;
+
+    QByteArray zpl;
+    zpl += "^XA\n";
+    zpl += "^CI28\n";   // 字段数据使用UTF-8
+    zpl += "^LH0,0\n";
+    zpl += "^PW" + QByteArray::number(m_labelSize.width()) + "\n";
+    zpl += "^LL" + QByteArray::number(m_labelSize.height()) + "\n";
+
+    for (const LabelItem *item : m_document->items()) {
+        // 与位图路径相同，完全位于页边距中的元素不输出
+        if (!m_document->isItemRendered(item)) {
+            continue;
+        }
+
+        bool native = false;
+        switch (item->type()) {
+            case LabelItem::TextType:
+                native = appendText(&zpl, static_cast<const TextItem*>(item));
+                break;
+            case LabelItem::BarcodeType:
+                native = appendBarcode(&zpl, static_cast<const BarcodeItem*>(item));
+                break;
+            case LabelItem::QRCodeType:
+                native = appendQRCode(&zpl, static_cast<const QRCodeItem*>(item));
+                break;
+            default:
+                break;
+        }
+
+        if (native) {
+            ++m_nativeFieldCount;
+        } else {
+            appendGraphic(&zpl, item);
+            ++m_graphicFieldCount;
+        }
+    }
+
+    zpl += "^XZ\n";
+
+    return zpl;
+}
+
+bool ZplExporter::exportToFile(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QFile::WriteOnly)) {
+        qWarning() << "无法写入文件" << fileName << ":" << file.errorString();
+        return false;
+    }
+
+    if (file.write(exportLabel()) < 0) {
+        qWarning() << "无法写入文件" << fileName << ":" << file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+int ZplExporter::nativeFieldCount() const
+{
+    return m_nativeFieldCount;
+}
+
+int ZplExporter::graphicFieldCount() const
+{
+    return m_graphicFieldCount;
+}
+
+bool ZplExporter::appendBarcode(QByteArray *zpl, const BarcodeItem *item) const
+{
+    if (!qFuzzyIsNull(item->rotation()) || !isInk(item->foregroundColor())
+        || !isPaper(item->backgroundColor()) || item->data().isEmpty()) {
+        return false;
+    }
+
+    // 屏幕上的符号由内置编码器生成时（ZXing无法编码），填充、校验位甚至码制都可能
+    // 与打印机的原生命令不同，改为输出图形
+    const BarcodeSymbol symbol = item->symbol();
+    const int modules = symbol.moduleCount();
+    if (modules <= 0 || symbol.isFallback()) {
+        return false;
+    }
+
+    // 与BarcodeItem的布局一致：四周留边距，文本位于条码下方
+    const QRectF rect(item->position(), item->size());
+    const qreal textHeight = item->showText() ? QFontMetricsF(item->textFont()).height() + 4 : 0;
+    const QRectF barRect = rect.adjusted(item->margin(), item->margin(),
+                                         -item->margin(), -item->margin() - textHeight);
+
+    const int moduleDots = toDots(barRect.width()) / modules;
+    const int barHeight = toDots(barRect.height());
+    if (moduleDots < 1 || barHeight < 1) {
+        return false;
+    }
+
+    const QByteArray f = item->showText() ? "Y" : "N";
+    const QByteArray h = QByteArray::number(barHeight);
+    QString data = item->data();
+    QByteArray command;
+    // 宽窄条比例与ZXing的写入器一致；定比例的码制忽略该参数
+    QByteArray ratio = "3";
+
+    switch (item->type()) {
+        case BarcodeType::Code128:
+            command = "^BCN," + h + "," + f + ",N,N,A";
+            break;
+        case BarcodeType::Code39:
+            // ZXing不附加校验字符（includeChecksum只影响内置编码器），打印机也不能附加
+            command = "^B3N,N," + h + "," + f + ",N";
+            ratio = "2.0";
+            break;
+        case BarcodeType::Code93:
+            command = "^BAN," + h + "," + f + ",N,N";
+            break;
+        case BarcodeType::EAN8:
+            // 打印机自行计算校验位
+            data = data.left(7);
+            command = "^B8N," + h + "," + f + ",N";
+            break;
+        case BarcodeType::EAN13:
+            data = data.left(12);
+            command = "^BEN," + h + "," + f + ",N";
+            break;
+        case BarcodeType::UPC_A:
+            data = data.left(11);
+            command = "^BUN," + h + "," + f + ",N,Y";
+            break;
+        case BarcodeType::UPC_E:
+            command = "^B9N," + h + "," + f + ",N,Y";
+            break;
+        case BarcodeType::MSI:
+            // 同Code 39，不附加校验位
+            command = "^BMN,A," + h + "," + f + ",N,N";
+            break;
+        case BarcodeType::Interleaved2of5:
+        case BarcodeType::ITF14:
+            // 与屏幕一致按原样编码；ITF-14的数据已经是含校验位的完整14位
+            command = "^B2N," + h + "," + f + ",N,N";
+            break;
+        case BarcodeType::Codabar: {
+            // 数据自带起止符时交给^BK参数
+            QByteArray start = "A";
+            QByteArray stop = "A";
+            static const QString startStop = QStringLiteral("ABCD");
+            if (data.size() >= 2 && startStop.contains(data.at(0).toUpper())
+                && startStop.contains(data.at(data.size() - 1).toUpper())) {
+                start = QString(data.at(0).toUpper()).toLatin1();
+                stop = QString(data.at(data.size() - 1).toUpper()).toLatin1();
+                data = data.mid(1, data.size() - 2);
+            }
+            command = "^BKN,N," + h + "," + f + ",N," + start + "," + stop;
+            ratio = "2.0";
+            break;
+        }
+        default:
+            return false;
+    }
+
+    const QPoint origin = toDots(barRect.topLeft());
+    *zpl += "^FO" + QByteArray::number(origin.x()) + "," + QByteArray::number(origin.y());
+    *zpl += "^BY" + QByteArray::number(qMin(moduleDots, MAX_MODULE_DOTS)) + "," + ratio + "," + h;
+    *zpl += command;
+    *zpl += "^FH^FD" + escapeFieldData(data) + "^FS\n";
+
+    return true;
+}
+
+bool ZplExporter::appendQRCode(QByteArray *zpl, const QRCodeItem *item) const
+{
+    if (!qFuzzyIsNull(item->rotation()) || !isInk(item->foregroundColor())
+        || !isPaper(item->backgroundColor()) || item->data().isEmpty()) {
+        return false;
+    }
+
+    const QRCodeMatrix matrix = QRCodeMatrix::encode(item->data(), item->errorCorrectionLevel());
+    if (!matrix.isValid()) {
+        return false;
+    }
+
+    // 与QRCodeItem::paintVector()相同的布局：元素较短边减去边距的正方形，按打印点取整模块
+    // （QRCodeItem::size()是二维码边长属性，这里需要元素尺寸）
+    const QRectF rect(item->position(), item->LabelItem::size());
+    const QRectF symbolRect = QRCodeItem::symbolArea(rect, item->margin());
+    if (symbolRect.isEmpty()) {
+        return false;
+    }
+
+    const int magnification = toDots(symbolRect.width()) / matrix.width();
+    if (magnification < 1) {
+        return false;
+    }
+
+    // 放大倍数取整后符号可能略小，保持与屏幕相同的中心
+    const int side = qMin(magnification, MAX_MODULE_DOTS) * matrix.width();
+    const QPoint origin = toDots(symbolRect.center()) - QPoint(side / 2, side / 2);
+    const char level = QRCodeItem::getErrorCorrectionLevelChar(item->errorCorrectionLevel());
+
+    *zpl += "^FO" + QByteArray::number(origin.x()) + "," + QByteArray::number(origin.y());
+    *zpl += "^BQN,2," + QByteArray::number(qMin(magnification, MAX_MODULE_DOTS));
+    *zpl += "^FH^FD" + QByteArray(1, level) + "A," + escapeFieldData(item->data()) + "^FS\n";
+
+    return true;
+}
+
+bool ZplExporter::appendText(QByteArray *zpl, const TextItem *item) const
+{
+    if (!qFuzzyIsNull(item->rotation()) || item->borderWidth() > 0
+        || !isInk(item->textColor()) || !isPaper(item->backgroundColor())) {
+        return false;
+    }
+
+    const QString text = item->text();
+    if (text.trimmed().isEmpty()) {
+        return false;
+    }
+
+    // 打印机内置字库只覆盖Latin-1，其余字符按图形输出
+    for (const QChar &ch : text) {
+        if (ch.unicode() > 0xff) {
+            return false;
+        }
+    }
+
+    // 与TextItem的绘制区域一致
+    const QRectF textRect = QRectF(item->position(), item->size()).adjusted(2, 2, -2, -2);
+    const int lineHeight = toDots(QFontMetricsF(item->font()).height());
+    const int width = toDots(textRect.width());
+    if (lineHeight < 1 || width < 1) {
+        return false;
+    }
+
+    const int maxLines = qMax(1, toDots(textRect.height()) / lineHeight);
+
+    QByteArray justification = "L";
+    const Qt::Alignment alignment = item->alignment() & Qt::AlignHorizontal_Mask;
+    if (alignment & Qt::AlignHCenter) {
+        justification = "C";
+    } else if (alignment & Qt::AlignRight) {
+        justification = "R";
+    } else if (alignment & Qt::AlignJustify) {
+        justification = "J";
+    }
+
+    const QPoint origin = toDots(textRect.topLeft());
+    *zpl += "^FO" + QByteArray::number(origin.x()) + "," + QByteArray::number(origin.y());
+    *zpl += "^A0N," + QByteArray::number(lineHeight);
+    *zpl += "^FB" + QByteArray::number(width) + "," + QByteArray::number(maxLines) + ",0," + justification + ",0";
+    *zpl += "^FH^FD" + escapeFieldData(text, true) + "^FS\n";
+
+    return true;
+}
+
+void ZplExporter::appendGraphic(QByteArray *zpl, const LabelItem *item) const
+{
+    // 旋转后的外接矩形（打印点）
+    QRectF rect(item->position(), item->size());
+    QTransform rotation;
+    rotation.translate(rect.center().x(), rect.center().y());
+    rotation.rotate(item->rotation());
+    rotation.translate(-rect.center().x(), -rect.center().y());
+
+    const QRect bounds = (rotation * m_transform).mapRect(rect).toAlignedRect()
+                         & QRect(QPoint(0, 0), m_labelSize);
+    if (bounds.isEmpty()) {
+        return;
+    }
+
+    // 单独光栅化该元素
+    QImage image(bounds.size(), QImage::Format_RGB32);
+    image.fill(Qt::white);
+
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setRenderHint(QPainter::TextAntialiasing);
+    painter.translate(-bounds.topLeft());
+    painter.setTransform(m_transform, true);
+
+    QStyleOptionGraphicsItem option;
+    option.state = QStyle::State_None;
+    const_cast<LabelItem*>(item)->paint(&painter, &option, nullptr);
+    painter.end();
+
+    // 图像元素抖动，其余内容按阈值二值化
+    const QRegion dither = item->type() == LabelItem::ImageType ? QRegion(image.rect()) : QRegion();
+    const QImage mono = MonoRenderer::toMono(image, 128, dither);
+
+    *zpl += "^FO" + QByteArray::number(bounds.x()) + "," + QByteArray::number(bounds.y());
+    *zpl += ZplGraphicEncoder::graphicField(mono, m_compression);
+    *zpl += "^FS\n";
+}
+
+QPoint ZplExporter::toDots(const QPointF &point) const
+{
+    return m_transform.map(point).toPoint();
+}
+
+int ZplExporter::toDots(qreal length) const
+{
+    return qRound(length * m_transform.m11());
+}
@@ -0,0 +1,144 @@
+#ifndef ZPLEXPORTER_H
+#define ZPLEXPORTER_H
+
+#include <QByteArray>
+#include <QRect>
+#include <QSize>
+#include <QString>
+#include <QTransform>
+
+#include "zplgraphicencoder.h"
+
+class LabelDocument;
+class LabelItem;
+class BarcodeItem;
+class QRCodeItem;
+class TextItem;
+
+/**
+ * @brief ZPL导出器
+ *
+ * 遍历文档元素生成ZPL II标签程序。条形码、二维码和简单文本
+ * 转换为打印机原生命令（^BC、^BE、^B3、^BQ、^A0等），由打印机自行
+ * 光栅化；图像元素以及无法用原生命令表达的元素（旋转、反色、
+ * 中文等打印机字库之外的字符）回退为^GF图形。
+ *
+ * 坐标按文档分辨率换算为打印点，与render()的页面映射一致。
+ */
+class ZplExporter
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param document 要导出的文档
+     */
+    explicit ZplExporter(const LabelDocument *document);
+
+    /**
+     * @brief 设置打印机分辨率
+     * @param dpi 分辨率（每英寸点数），通常为203、300或600
+     */
+    void setResolution(int dpi);
+
+    /**
+     * @brief 获取打印机分辨率
+     * @return 分辨率
+     */
+    int resolution() const;
+
+    /**
+     * @brief 设置图形字段的编码方式
+     * @param compression 编码方式，默认取最短的一种
+     */
+    void setCompression(ZplGraphicEncoder::Compression compression);
+
+    /**
+     * @brief 获取图形字段的编码方式
+     * @return 编码方式
+     */
+    ZplGraphicEncoder::Compression compression() const;
+
+    /**
+     * @brief 生成一张标签的ZPL程序
+     *
+     * 文档绑定了数据合并时，每次应用记录后调用一次
+     *
+     * @return ZPL程序（^XA ... ^XZ）
+     */
+    QByteArray exportLabel();
+
+    /**
+     * @brief 导出到文件
+     * @param fileName 文件路径
+     * @return 是否成功
+     */
+    bool exportToFile(const QString &fileName);
+
+    /**
+     * @brief 获取上次导出时使用原生命令的元素数量
+     * @return 元素数量
+     */
+    int nativeFieldCount() const;
+
+    /**
+     * @brief 获取上次导出时回退为图形的元素数量
+     * @return 元素数量
+     */
+    int graphicFieldCount() const;
+
+private:
+    /**
+     * @brief 输出条形码字段
+     * @param zpl 输出缓冲区
+     * @param item 条形码元素
+     * @return 是否可用原生命令表达
+     */
+    bool appendBarcode(QByteArray *zpl, const BarcodeItem *item) const;
+
+    /**
+     * @brief 输出二维码字段
+     * @param zpl 输出缓冲区
+     * @param item 二维码元素
+     * @return 是否可用原生命令表达
+     */
+    bool appendQRCode(QByteArray *zpl, const QRCodeItem *item) const;
+
+    /**
+     * @brief 输出文本字段
+     * @param zpl 输出缓冲区
+     * @param item 文本元素
+     * @return 是否可用原生命令表达
+     */
+    bool appendText(QByteArray *zpl, const TextItem *item) const;
+
+    /**
+     * @brief 将元素光栅化为^GF图形字段
+     * @param zpl 输出缓冲区
+     * @param item 元素
+     */
+    void appendGraphic(QByteArray *zpl, const LabelItem *item) const;
+
+    /**
+     * @brief 将页面坐标换算为打印点
+     * @param point 页面坐标
+     * @return 打印点坐标
+     */
+    QPoint toDots(const QPointF &point) const;
+
+    /**
+     * @brief 将页面长度换算为打印点
+     * @param length 页面长度
+     * @return 打印点数
+     */
+    int toDots(qreal length) const;
+
+    const LabelDocument *m_document;    ///< 要导出的文档
+    int m_dpi;                          ///< 打印机分辨率
+    QSize m_labelSize;                  ///< 标签大小（打印点）
+    QTransform m_transform;             ///< 页面坐标到打印点的变换
+    ZplGraphicEncoder::Compression m_compression; ///< 图形字段编码方式
+    int m_nativeFieldCount;             ///< 原生命令字段数
+    int m_graphicFieldCount;            ///< 图形字段数
+};
+
+#endif // ZPLEXPORTER_H
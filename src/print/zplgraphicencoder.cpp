@@ -0,0 +1,182 @@
+#include "zplgraphicencoder.h"
+#include "../models/labelmodels.h"
+#include "../render/monorenderer.h"
+
+#include <cstring>
+
+// 十六进制字符
+static const char HEX_DIGITS[] = "0123456789ABCDEF";
+
+// ACS单个计数字符能表示的最大重复次数（z）
+static const int ACS_MAX_COUNT = 400;
+
+/**
+ * @brief 输出ACS重复计数和字符
+ *
+ * G-Y表示1-19次，g-z表示20-400次（按20递增），多个计数字符累加
+ *
+ * @param out 输出缓冲区
+ * @param ch 十六进制字符
+ * @param count 重复次数
+ */
+static void appendAcsRun(QByteArray *out, char ch, int count)
+{
+    if (count > 1) {
+        while (count >= ACS_MAX_COUNT) {
+            out->append('z');
+            count -= ACS_MAX_COUNT;
+        }
+        if (count >= 20) {
+            out->append(static_cast<char>('g' + count / 20 - 1));
+            count %= 20;
+        }
+        if (count > 0) {
+            out->append(static_cast<char>('G' + count - 1));
+        }
+    }
+    out->append(ch);
+}
+
+QByteArray ZplGraphicEncoder::graphicField(const QByteArray &rows, int bytesPerRow, Compression compression)
+{
+    QByteArray data;
+    switch (compression) {
+        case Hex:
+            data = encodeHex(rows);
+            break;
+        case Acs:
+            data = encodeAcs(rows, bytesPerRow);
+            break;
+        case Z64:
+            data = encodeZ64(rows);
+            break;
+        case Smallest: {
+            data = encodeHex(rows);
+
+            QByteArray acs = encodeAcs(rows, bytesPerRow);
+            if (acs.size() < data.size()) {
+                data = acs;
+            }
+
+            QByteArray z64 = encodeZ64(rows);
+            if (z64.size() < data.size()) {
+                data = z64;
+            }
+            break;
+        }
+    }
+
+    const QByteArray total = QByteArray::number(rows.size());
+    return "^GFA," + total + "," + total + "," + QByteArray::number(bytesPerRow) + "," + data;
+}
+
+QByteArray ZplGraphicEncoder::graphicField(const QImage &image, Compression compression)
+{
+    int bytesPerRow = 0;
+    const QByteArray rows = MonoRenderer::packRows(image, &bytesPerRow);
+    return graphicField(rows, bytesPerRow, compression);
+}
+
+QByteArray ZplGraphicEncoder::rasterLabel(const LabelDocument *document, int dpi, Compression compression)
+{
+    MonoRenderer renderer(document);
+    renderer.setResolution(dpi);
+    const QImage mono = renderer.renderMono();
+
+    QByteArray zpl;
+    zpl += "^XA\n";
+    zpl += "^LH0,0\n";
+    zpl += "^PW" + QByteArray::number(mono.width()) + "\n";
+    zpl += "^LL" + QByteArray::number(mono.height()) + "\n";
+    zpl += "^FO0,0" + graphicField(mono, compression) + "^FS\n";
+    zpl += "^XZ\n";
+
+    return zpl;
+}
+
+QByteArray ZplGraphicEncoder::encodeHex(const QByteArray &rows)
+{
+    return rows.toHex().toUpper();
+}
+
+QByteArray ZplGraphicEncoder::encodeAcs(const QByteArray &rows, int bytesPerRow)
+{
+    if (bytesPerRow <= 0) {
+        return QByteArray();
+    }
+
+    const int rowCount = rows.size() / bytesPerRow;
+    const int digits = bytesPerRow * 2;
+
+    QByteArray out;
+    out.reserve(rows.size() / 4 + rowCount);
+
+    // 每行展开为十六进制字符后做行程编码
+    QByteArray line(digits, '0');
+
+    for (int y = 0; y < rowCount; ++y) {
+        const uchar *row = reinterpret_cast<const uchar*>(rows.constData()) + y * bytesPerRow;
+
+        // 与上一行相同
+        if (y > 0 && std::memcmp(row, row - bytesPerRow, static_cast<size_t>(bytesPerRow)) == 0) {
+            out.append(':');
+            continue;
+        }
+
+        for (int i = 0; i < bytesPerRow; ++i) {
+            line[2 * i] = HEX_DIGITS[row[i] >> 4];
+            line[2 * i + 1] = HEX_DIGITS[row[i] & 0x0f];
+        }
+
+        // 行尾连续的0或F分别用","和"!"代替
+        int end = digits;
+        char tail = 0;
+        if (line.at(end - 1) == '0' || line.at(end - 1) == 'F') {
+            tail = line.at(end - 1);
+            while (end > 0 && line.at(end - 1) == tail) {
+                --end;
+            }
+        }
+
+        int x = 0;
+        while (x < end) {
+            const char ch = line.at(x);
+            int run = 1;
+            while (x + run < end && line.at(x + run) == ch) {
+                ++run;
+            }
+            appendAcsRun(&out, ch, run);
+            x += run;
+        }
+
+        if (tail == '0') {
+            out.append(',');
+        } else if (tail == 'F') {
+            out.append('!');
+        }
+    }
+
+    return out;
+}
+
+QByteArray ZplGraphicEncoder::encodeZ64(const QByteArray &rows)
+{
+    // qCompress在zlib数据前附加4字节长度，Z64只需要zlib数据
+    const QByteArray compressed = qCompress(rows, 9).mid(4);
+    const QByteArray base64 = compressed.toBase64();
+    const QByteArray crc = QByteArray::number(crc16(base64), 16).toUpper().rightJustified(4, '0');
+
+    return ":Z64:" + base64 + ":" + crc;
+}
+
+quint16 ZplGraphicEncoder::crc16(const QByteArray &data)
+{
+    quint16 crc = 0;
+    for (char ch : data) {
+        crc ^= static_cast<quint16>(static_cast<uchar>(ch)) << 8;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 0x8000) ? static_cast<quint16>((crc << 1) ^ 0x1021) : static_cast<quint16>(crc << 1);
+        }
+    }
+    return crc;
+}
@@ -0,0 +1,93 @@
+#ifndef ZPLGRAPHICENCODER_H
+#define ZPLGRAPHICENCODER_H
+
+#include <QByteArray>
+#include <QImage>
+
+class LabelDocument;
+
+/**
+ * @brief ZPL图形数据编码器
+ *
+ * 将1位位行编码为^GFA图形字段的数据，支持三种格式：
+ * - 十六进制：每字节两个字符，不压缩
+ * - ACS：ZPL的ASCII行程压缩（G-Y、g-z重复计数，","补0，"!"补1，":"重复上一行）
+ * - Z64：zlib压缩后Base64编码，末尾附加CRC-16校验
+ *
+ * 位行格式与MonoRenderer::packRows()一致：每行bytesPerRow字节，
+ * 高位在前，1表示黑点。
+ */
+class ZplGraphicEncoder
+{
+public:
+    /**
+     * @brief 图形数据编码方式
+     */
+    enum Compression {
+        Hex,        ///< 不压缩的十六进制
+        Acs,        ///< ASCII行程压缩
+        Z64,        ///< zlib + Base64
+        Smallest    ///< 分别编码后取最短的一种
+    };
+
+    /**
+     * @brief 生成^GFA命令
+     * @param rows 位行数据
+     * @param bytesPerRow 每行字节数
+     * @param compression 编码方式
+     * @return ^GFA,总字节数,总字节数,每行字节数,数据（不含^FO和^FS）
+     */
+    static QByteArray graphicField(const QByteArray &rows, int bytesPerRow, Compression compression = Smallest);
+
+    /**
+     * @brief 将单色图像编码为^GFA命令
+     * @param image 图像（非Format_Mono时按阈值二值化）
+     * @param compression 编码方式
+     * @return ^GFA命令
+     */
+    static QByteArray graphicField(const QImage &image, Compression compression = Smallest);
+
+    /**
+     * @brief 将整个文档光栅化为一张ZPL标签
+     *
+     * 按打印机分辨率做1位渲染（文本条码阈值化，图像元素抖动），
+     * 整张标签作为一个图形字段输出，适用于不使用打印机字库的场合
+     *
+     * @param document 文档
+     * @param dpi 打印机分辨率
+     * @param compression 编码方式
+     * @return ZPL程序（^XA ... ^XZ）
+     */
+    static QByteArray rasterLabel(const LabelDocument *document, int dpi, Compression compression = Smallest);
+
+    /**
+     * @brief 十六进制编码
+     * @param rows 位行数据
+     * @return 编码数据
+     */
+    static QByteArray encodeHex(const QByteArray &rows);
+
+    /**
+     * @brief ACS行程压缩编码
+     * @param rows 位行数据
+     * @param bytesPerRow 每行字节数
+     * @return 编码数据
+     */
+    static QByteArray encodeAcs(const QByteArray &rows, int bytesPerRow);
+
+    /**
+     * @brief Z64编码
+     * @param rows 位行数据
+     * @return 编码数据（:Z64:数据:CRC）
+     */
+    static QByteArray encodeZ64(const QByteArray &rows);
+
+    /**
+     * @brief 计算CRC-16/CCITT（多项式0x1021，初值0）
+     * @param data 数据
+     * @return 校验值
+     */
+    static quint16 crc16(const QByteArray &data);
+};
+
+#endif // ZPLGRAPHICENCODER_H
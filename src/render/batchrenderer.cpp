@@ -0,0 +1,217 @@
+#include "batchrenderer.h"
+#include "../models/labelmodels.h"
+#include "renderplan.h"
+
+#include <QAtomicInt>
+#include <QMutex>
+#include <QRunnable>
+#include <QThread>
+#include <QDebug>
+
+#include <algorithm>
+
+// 毫米与英寸的换算
+static const qreal MM_PER_INCH = 25.4;
+
+/**
+ * @brief 批次共享状态
+ *
+ * 除原子计数器和受互斥锁保护的错误列表外，工作线程只读访问
+ */
+struct BatchState
+{
+    QJsonObject snapshot;                       ///< 文档快照
+    QStringList columns;                        ///< 数据列名
+    QSize imageSize;                            ///< 输出图像大小
+    int dotsPerMeter;                           ///< 输出图像的物理分辨率
+    int count;                                  ///< 标签数量
+    const QList<QStringList> *records;          ///< 记录列表
+    BatchRenderer::ImageHandler handler;        ///< 图像处理回调
+    bool skipInvalid;                           ///< 是否跳过无效记录
+    QAtomicInt next;                            ///< 下一个待渲染的标签序号
+    QAtomicInt failed;                          ///< 是否有任务失败
+    QMutex errorMutex;                          ///< 保护无效记录列表
+    QVector<DataMergeEngine::RecordError> errors; ///< 无效记录
+};
+
+/**
+ * @brief 批量渲染工作任务
+ *
+ * 每个任务拥有独立的文档副本、合并引擎和画布，
+ * 循环领取标签序号直到全部完成
+ */
+class BatchRenderTask : public QRunnable
+{
+public:
+    explicit BatchRenderTask(BatchState *state)
+        : m_state(state)
+    {
+    }
+
+    void run() override
+    {
+        // 在工作线程中重建文档副本
+        LabelDocument document;
+        if (!document.fromJson(m_state->snapshot)) {
+            m_state->failed.storeRelease(1);
+            return;
+        }
+
+        DataMergeEngine engine;
+        if (m_state->records) {
+            engine.bind(&document);
+            engine.setColumns(m_state->columns);
+        }
+
+        // 不含占位符的元素只光栅化一次，之后每张标签只绘制动态元素
+        RenderPlan plan = document.compileRenderPlan(m_state->imageSize, engine.boundItems());
+
+        QImage image;
+
+        while (!m_state->failed.loadAcquire()) {
+            int index = m_state->next.fetchAndAddRelaxed(1);
+            if (index >= m_state->count) {
+                break;
+            }
+
+            // 无效记录不输出标签，否则条形码会沿用上一条记录的数据
+            QString errorString;
+            if (m_state->records && !engine.apply(m_state->records->at(index), &errorString)) {
+                {
+                    QMutexLocker locker(&m_state->errorMutex);
+                    m_state->errors.append({index, errorString});
+                }
+
+                if (m_state->skipInvalid) {
+                    continue;
+                }
+                m_state->failed.storeRelease(1);
+                break;
+            }
+
+            plan.renderInto(&image);
+            image.setDotsPerMeterX(m_state->dotsPerMeter);
+            image.setDotsPerMeterY(m_state->dotsPerMeter);
+
+            if (!m_state->handler(index, image)) {
+                m_state->failed.storeRelease(1);
+                break;
+            }
+        }
+    }
+
+private:
+    BatchState *m_state;    ///< 批次共享状态
+};
+
+// ================= BatchRenderer 类实现 =================
+
+BatchRenderer::BatchRenderer(const LabelDocument *document)
+    : m_snapshot(document->toJson())
+    , m_pageSize(document->pageRealSize())
+    , m_dpi(0)
+    , m_skipInvalid(false)
+{
+    setResolution(document->dpi());
+    setThreadCount(0);
+}
+
+BatchRenderer::~BatchRenderer()
+{
+    m_pool.waitForDone();
+}
+
+void BatchRenderer::setResolution(int dpi)
+{
+    m_dpi = qMax(1, dpi);
+    m_imageSize = QSize(qMax(1, qRound(m_pageSize.width() * m_dpi / MM_PER_INCH)),
+                        qMax(1, qRound(m_pageSize.height() * m_dpi / MM_PER_INCH)));
+}
+
+int BatchRenderer::resolution() const
+{
+    return m_dpi;
+}
+
+QSize BatchRenderer::imageSize() const
+{
+    return m_imageSize;
+}
+
+void BatchRenderer::setThreadCount(int count)
+{
+    m_pool.setMaxThreadCount(count > 0 ? count : qMax(1, QThread::idealThreadCount()));
+}
+
+int BatchRenderer::threadCount() const
+{
+    return m_pool.maxThreadCount();
+}
+
+void BatchRenderer::setColumns(const QStringList &columns)
+{
+    m_columns = columns;
+}
+
+void BatchRenderer::setSkipInvalidRecords(bool skip)
+{
+    m_skipInvalid = skip;
+}
+
+bool BatchRenderer::skipInvalidRecords() const
+{
+    return m_skipInvalid;
+}
+
+QVector<DataMergeEngine::RecordError> BatchRenderer::invalidRecords() const
+{
+    return m_invalidRecords;
+}
+
+bool BatchRenderer::renderCopies(int copies, const ImageHandler &handler)
+{
+    return run(copies, nullptr, handler);
+}
+
+bool BatchRenderer::renderRecords(const QList<QStringList> &records, const ImageHandler &handler)
+{
+    return run(records.size(), &records, handler);
+}
+
+bool BatchRenderer::run(int count, const QList<QStringList> *records, const ImageHandler &handler)
+{
+    m_invalidRecords.clear();
+
+    if (count <= 0 || !handler) {
+        return count == 0;
+    }
+
+    BatchState state;
+    state.snapshot = m_snapshot;
+    state.columns = m_columns;
+    state.imageSize = m_imageSize;
+    state.dotsPerMeter = qRound(m_dpi * 1000.0 / MM_PER_INCH);
+    state.count = count;
+    state.records = records;
+    state.handler = handler;
+    state.skipInvalid = m_skipInvalid;
+    state.next.storeRelaxed(0);
+    state.failed.storeRelaxed(0);
+
+    // 每个线程一个任务，任务内部动态领取标签，避免为每张标签重建文档
+    int taskCount = qMin(count, m_pool.maxThreadCount());
+    for (int i = 0; i < taskCount; ++i) {
+        m_pool.start(new BatchRenderTask(&state));
+    }
+
+    m_pool.waitForDone();
+
+    // 各线程按领取顺序追加，整理为按序号排序
+    m_invalidRecords = state.errors;
+    std::sort(m_invalidRecords.begin(), m_invalidRecords.end(),
+              [](const DataMergeEngine::RecordError &a, const DataMergeEngine::RecordError &b) {
+        return a.record < b.record;
+    });
+
+    return !state.failed.loadAcquire();
+}
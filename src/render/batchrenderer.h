@@ -0,0 +1,145 @@
+#ifndef BATCHRENDERER_H
+#define BATCHRENDERER_H
+
+#include <QImage>
+#include <QJsonObject>
+#include <QList>
+#include <QSize>
+#include <QStringList>
+#include <QThreadPool>
+#include <QVector>
+
+#include <functional>
+
+#include "../models/datamerge.h"
+
+class LabelDocument;
+
+/**
+ * @brief 多线程批量渲染器
+ *
+ * 在线程池上并行光栅化相互独立的标签（数据记录或重复份数）。
+ * 构造时保存文档快照，每个工作线程由快照重建自己的文档副本，
+ * 并独占自己的QImage和QPainter，不会触碰场景中的元素。
+ */
+class BatchRenderer
+{
+public:
+    /**
+     * @brief 图像处理回调
+     *
+     * 在工作线程中调用，参数为标签序号（从0开始）和渲染结果。
+     * 图像在同一线程的下一个标签中会被复用，需要保留时请复制。
+     * 返回false将终止整个批次。
+     */
+    typedef std::function<bool(int index, const QImage &image)> ImageHandler;
+
+    /**
+     * @brief 构造函数
+     * @param document 模板文档（构造时保存快照）
+     */
+    explicit BatchRenderer(const LabelDocument *document);
+
+    /**
+     * @brief 析构函数
+     */
+    ~BatchRenderer();
+
+    /**
+     * @brief 设置输出分辨率
+     *
+     * 根据文档页面尺寸计算输出图像大小
+     *
+     * @param dpi 分辨率（每英寸点数）
+     */
+    void setResolution(int dpi);
+
+    /**
+     * @brief 获取输出分辨率
+     * @return 分辨率
+     */
+    int resolution() const;
+
+    /**
+     * @brief 获取输出图像大小
+     * @return 图像大小
+     */
+    QSize imageSize() const;
+
+    /**
+     * @brief 设置工作线程数
+     * @param count 线程数，0表示使用CPU核心数
+     */
+    void setThreadCount(int count);
+
+    /**
+     * @brief 获取工作线程数
+     * @return 线程数
+     */
+    int threadCount() const;
+
+    /**
+     * @brief 设置数据列名
+     * @param columns 列名列表，用于合并记录
+     */
+    void setColumns(const QStringList &columns);
+
+    /**
+     * @brief 设置是否跳过无效记录
+     *
+     * 条形码数据无效的记录不会输出标签。不跳过时整个批次在第一条无效记录处终止，
+     * 跳过时其余记录照常输出。两种情况下无效记录都可以通过invalidRecords()获取。
+     *
+     * @param skip 是否跳过
+     */
+    void setSkipInvalidRecords(bool skip);
+
+    /**
+     * @brief 获取是否跳过无效记录
+     * @return 是否跳过
+     */
+    bool skipInvalidRecords() const;
+
+    /**
+     * @brief 获取上一次renderRecords()中的无效记录
+     * @return 无效记录，按序号排序（序号相对于传入的记录列表）
+     */
+    QVector<DataMergeEngine::RecordError> invalidRecords() const;
+
+    /**
+     * @brief 渲染多份相同的标签
+     * @param copies 份数
+     * @param handler 图像处理回调
+     * @return 是否全部成功
+     */
+    bool renderCopies(int copies, const ImageHandler &handler);
+
+    /**
+     * @brief 按数据记录渲染标签
+     * @param records 记录列表，每条记录输出一张标签
+     * @param handler 图像处理回调
+     * @return 是否全部成功
+     */
+    bool renderRecords(const QList<QStringList> &records, const ImageHandler &handler);
+
+private:
+    /**
+     * @brief 分发渲染任务并等待完成
+     * @param count 标签数量
+     * @param records 记录列表，为nullptr时不合并数据
+     * @param handler 图像处理回调
+     * @return 是否全部成功
+     */
+    bool run(int count, const QList<QStringList> *records, const ImageHandler &handler);
+
+    QJsonObject m_snapshot;     ///< 文档快照
+    QSizeF m_pageSize;          ///< 页面尺寸（毫米）
+    int m_dpi;                  ///< 输出分辨率
+    QSize m_imageSize;          ///< 输出图像大小
+    QStringList m_columns;      ///< 数据列名
+    bool m_skipInvalid;         ///< 是否跳过无效记录
+    QVector<DataMergeEngine::RecordError> m_invalidRecords; ///< 上一批次的无效记录
+    QThreadPool m_pool;         ///< 线程池
+};
+
+#endif // BATCHRENDERER_H
@@ -0,0 +1,266 @@
+#include "monorenderer.h"
+#include "../models/labelmodels.h"
+#include "../items/labelitem.h"
+
+#include <QPainter>
+#include <QTransform>
+#include <QVector>
+
+#include <algorithm>
+#include <cstring>
+
+// 毫米与英寸的换算
+static const qreal MM_PER_INCH = 25.4;
+
+// 条带渲染时每次光栅化的行数
+static const int BAND_HEIGHT = 256;
+
+/**
+ * @brief 对灰度图像的一个矩形区域做Floyd-Steinberg误差扩散
+ * @param gray 灰度图像
+ * @param rect 区域
+ * @param threshold 阈值
+ * @param mono 输出单色图像（只改写区域内的位）
+ */
+static void ditherRect(const QImage &gray, const QRect &rect, int threshold, QImage *mono)
+{
+    const int width = rect.width();
+
+    // 误差缓冲区两侧各留一个元素，省去边界判断
+    QVector<int> current(width + 2, 0);
+    QVector<int> next(width + 2, 0);
+
+    for (int y = rect.top(); y <= rect.bottom(); ++y) {
+        const uchar *src = gray.constScanLine(y) + rect.left();
+        uchar *dst = mono->scanLine(y);
+        int *err = current.data() + 1;
+        int *below = next.data() + 1;
+
+        std::fill(next.begin(), next.end(), 0);
+
+        for (int i = 0; i < width; ++i) {
+            const int x = rect.left() + i;
+            const int value = src[i] + err[i];
+            const uchar mask = 0x80 >> (x & 7);
+
+            int quantized;
+            if (value < threshold) {
+                dst[x >> 3] |= mask;
+                quantized = 0;
+            } else {
+                dst[x >> 3] &= ~mask;
+                quantized = 255;
+            }
+
+            const int error = value - quantized;
+            err[i + 1] += (error * 7) >> 4;
+            below[i - 1] += (error * 3) >> 4;
+            below[i] += (error * 5) >> 4;
+            below[i + 1] += error >> 4;
+        }
+
+        current.swap(next);
+    }
+}
+
+// ================= MonoRenderer 类实现 =================
+
+MonoRenderer::MonoRenderer(const LabelDocument *document)
+    : m_document(document)
+    , m_dpi(0)
+    , m_threshold(128)
+{
+    setResolution(document->dpi());
+}
+
+void MonoRenderer::setResolution(int dpi)
+{
+    m_dpi = qMax(1, dpi);
+
+    QSizeF pageSize = m_document->pageRealSize();
+    m_imageSize = QSize(qMax(1, qRound(pageSize.width() * m_dpi / MM_PER_INCH)),
+                        qMax(1, qRound(pageSize.height() * m_dpi / MM_PER_INCH)));
+}
+
+int MonoRenderer::resolution() const
+{
+    return m_dpi;
+}
+
+QSize MonoRenderer::imageSize() const
+{
+    return m_imageSize;
+}
+
+void MonoRenderer::setThreshold(int threshold)
+{
+    m_threshold = qBound(0, threshold, 255);
+}
+
+int MonoRenderer::threshold() const
+{
+    return m_threshold;
+}
+
+QRegion MonoRenderer::ditherRegion() const
+{
+    const QRect imageRect(QPoint(0, 0), m_imageSize);
+    const QTransform transform = m_document->pageTransform(imageRect);
+
+    QRegion region;
+    for (const LabelItem *item : m_document->items()) {
+        if (!item->isVisible() || item->type() != LabelItem::ImageType) {
+            continue;
+        }
+
+        // 旋转后的外接矩形
+        QRectF bounds(item->position(), item->size());
+        QTransform rotation;
+        rotation.translate(bounds.center().x(), bounds.center().y());
+        rotation.rotate(item->rotation());
+        rotation.translate(-bounds.center().x(), -bounds.center().y());
+
+        region += (rotation * transform).mapRect(bounds).toAlignedRect() & imageRect;
+    }
+
+    return region;
+}
+
+QImage MonoRenderer::renderGrayscale() const
+{
+    QImage gray(m_imageSize, QImage::Format_Grayscale8);
+    const int dotsPerMeter = qRound(m_dpi * 1000.0 / MM_PER_INCH);
+    gray.setDotsPerMeterX(dotsPerMeter);
+    gray.setDotsPerMeterY(dotsPerMeter);
+
+    const QRectF pageRect(QPointF(0, 0), m_imageSize);
+    QImage band(m_imageSize.width(), qMin(BAND_HEIGHT, m_imageSize.height()), QImage::Format_RGB32);
+
+    for (int top = 0; top < m_imageSize.height(); top += band.height()) {
+        const int rows = qMin(band.height(), m_imageSize.height() - top);
+
+        // 裁剪到当前条带，条带外的元素在render()中被剔除
+        QPainter painter(&band);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.setRenderHint(QPainter::TextAntialiasing);
+        painter.setClipRect(0, 0, band.width(), rows);
+        painter.translate(0, -top);
+        m_document->render(&painter, pageRect);
+        painter.end();
+
+        for (int y = 0; y < rows; ++y) {
+            const QRgb *src = reinterpret_cast<const QRgb*>(band.constScanLine(y));
+            uchar *dst = gray.scanLine(top + y);
+            for (int x = 0; x < m_imageSize.width(); ++x) {
+                dst[x] = static_cast<uchar>(qGray(src[x]));
+            }
+        }
+    }
+
+    return gray;
+}
+
+QImage MonoRenderer::renderMono() const
+{
+    return toMono(renderGrayscale(), m_threshold, ditherRegion());
+}
+
+QImage MonoRenderer::toGrayscale(const QImage &image)
+{
+    if (image.format() == QImage::Format_Grayscale8) {
+        return image;
+    }
+
+    // 透明像素按白色纸张处理
+    QImage source = image.convertToFormat(QImage::Format_ARGB32);
+    QImage gray(source.size(), QImage::Format_Grayscale8);
+    gray.setDotsPerMeterX(image.dotsPerMeterX());
+    gray.setDotsPerMeterY(image.dotsPerMeterY());
+
+    for (int y = 0; y < source.height(); ++y) {
+        const QRgb *src = reinterpret_cast<const QRgb*>(source.constScanLine(y));
+        uchar *dst = gray.scanLine(y);
+        for (int x = 0; x < source.width(); ++x) {
+            const int alpha = qAlpha(src[x]);
+            dst[x] = static_cast<uchar>((qGray(src[x]) * alpha + 255 * (255 - alpha)) / 255);
+        }
+    }
+
+    return gray;
+}
+
+QImage MonoRenderer::toMono(const QImage &image, int threshold, const QRegion &ditherRegion)
+{
+    const QImage gray = toGrayscale(image);
+    const int width = gray.width();
+
+    QImage mono(gray.size(), QImage::Format_Mono);
+    mono.setColorTable(QVector<QRgb>() << qRgb(255, 255, 255) << qRgb(0, 0, 0));
+    mono.setDotsPerMeterX(gray.dotsPerMeterX());
+    mono.setDotsPerMeterY(gray.dotsPerMeterY());
+    mono.fill(0);
+
+    // 阈值二值化，每次生成一个字节（8个像素）
+    for (int y = 0; y < gray.height(); ++y) {
+        const uchar *src = gray.constScanLine(y);
+        uchar *dst = mono.scanLine(y);
+
+        int x = 0;
+        for (; x + 8 <= width; x += 8) {
+            uchar bits = 0;
+            for (int k = 0; k < 8; ++k) {
+                bits = static_cast<uchar>((bits << 1) | (src[x + k] < threshold ? 1 : 0));
+            }
+            dst[x >> 3] = bits;
+        }
+        for (; x < width; ++x) {
+            if (src[x] < threshold) {
+                dst[x >> 3] |= 0x80 >> (x & 7);
+            }
+        }
+    }
+
+    // 图像区域改为误差扩散
+    const QRegion region = ditherRegion & QRect(QPoint(0, 0), gray.size());
+    for (const QRect &rect : region) {
+        ditherRect(gray, rect, threshold, &mono);
+    }
+
+    return mono;
+}
+
+QByteArray MonoRenderer::packRows(const QImage &image, int *bytesPerRow)
+{
+    QImage mono = image;
+    if (mono.format() != QImage::Format_Mono) {
+        mono = toMono(image, 128);
+    }
+
+    const int rowBytes = (mono.width() + 7) / 8;
+    if (bytesPerRow) {
+        *bytesPerRow = rowBytes;
+    }
+
+    // 颜色表第0项为黑色时需要反转，保证1表示黑点
+    const bool invert = mono.colorCount() > 1 && qGray(mono.color(0)) < qGray(mono.color(1));
+    const int spareBits = rowBytes * 8 - mono.width();
+    const uchar lastMask = static_cast<uchar>(0xff << spareBits);
+
+    QByteArray data(rowBytes * mono.height(), Qt::Uninitialized);
+    uchar *dst = reinterpret_cast<uchar*>(data.data());
+
+    for (int y = 0; y < mono.height(); ++y) {
+        std::memcpy(dst, mono.constScanLine(y), static_cast<size_t>(rowBytes));
+        if (invert) {
+            for (int i = 0; i < rowBytes; ++i) {
+                dst[i] = static_cast<uchar>(~dst[i]);
+            }
+        }
+        if (rowBytes > 0) {
+            dst[rowBytes - 1] &= lastMask;
+        }
+        dst += rowBytes;
+    }
+
+    return data;
+}
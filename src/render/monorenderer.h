@@ -0,0 +1,118 @@
+#ifndef MONORENDERER_H
+#define MONORENDERER_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QRegion>
+#include <QSize>
+
+class LabelDocument;
+
+/**
+ * @brief 单色与灰度渲染器
+ *
+ * 按打印机原生分辨率输出Format_Grayscale8（激光打印机）或
+ * Format_Mono（热敏打印机）图像。文档按水平条带光栅化后立即
+ * 转为灰度，不需要整页的32位中间图像。
+ *
+ * 单色输出时文本、条码等线条内容按阈值二值化以保持边缘锐利，
+ * 图像元素所在区域使用Floyd-Steinberg误差扩散抖动以保留层次。
+ * 单色图像颜色表为{白, 黑}，像素值1表示打印（黑点）。
+ */
+class MonoRenderer
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param document 要渲染的文档
+     */
+    explicit MonoRenderer(const LabelDocument *document);
+
+    /**
+     * @brief 设置输出分辨率
+     * @param dpi 分辨率（每英寸点数）
+     */
+    void setResolution(int dpi);
+
+    /**
+     * @brief 获取输出分辨率
+     * @return 分辨率
+     */
+    int resolution() const;
+
+    /**
+     * @brief 获取输出图像大小
+     * @return 图像大小
+     */
+    QSize imageSize() const;
+
+    /**
+     * @brief 设置二值化阈值
+     * @param threshold 阈值（0-255），灰度低于阈值的像素打印为黑点
+     */
+    void setThreshold(int threshold);
+
+    /**
+     * @brief 获取二值化阈值
+     * @return 阈值
+     */
+    int threshold() const;
+
+    /**
+     * @brief 获取需要抖动的区域
+     *
+     * 即文档中可见图像元素在输出图像中的像素范围
+     *
+     * @return 抖动区域
+     */
+    QRegion ditherRegion() const;
+
+    /**
+     * @brief 渲染为8位灰度图像
+     * @return Format_Grayscale8图像
+     */
+    QImage renderGrayscale() const;
+
+    /**
+     * @brief 渲染为1位单色图像
+     * @return Format_Mono图像
+     */
+    QImage renderMono() const;
+
+    /**
+     * @brief 将已渲染的图像转换为8位灰度
+     * @param image 源图像
+     * @return Format_Grayscale8图像
+     */
+    static QImage toGrayscale(const QImage &image);
+
+    /**
+     * @brief 将已渲染的图像转换为1位单色
+     * @param image 源图像（任意格式，非灰度时先转换为灰度）
+     * @param threshold 二值化阈值
+     * @param ditherRegion 使用误差扩散抖动的区域
+     * @return Format_Mono图像
+     */
+    static QImage toMono(const QImage &image, int threshold, const QRegion &ditherRegion = QRegion());
+
+    /**
+     * @brief 提取紧凑排列的位行
+     *
+     * 去掉QImage每行的32位对齐填充，每行(width + 7) / 8字节，
+     * 高位在前，1表示黑点，行尾多余的位清零。
+     * 可直接用于打印机的位图命令。
+     *
+     * @param image Format_Mono图像
+     * @param bytesPerRow 输出每行字节数，可为nullptr
+     * @return 位行数据
+     */
+    static QByteArray packRows(const QImage &image, int *bytesPerRow = nullptr);
+
+private:
+    const LabelDocument *m_document;    ///< 要渲染的文档
+    int m_dpi;                          ///< 输出分辨率
+    QSize m_imageSize;                  ///< 输出图像大小
+    int m_threshold;                    ///< 二值化阈值
+};
+
+#endif // MONORENDERER_H
@@ -0,0 +1,81 @@
+#include "renderplan.h"
+#include "../items/labelitem.h"
+
+#include <QStyleOptionGraphicsItem>
+
+#include <cstring>
+
+RenderPlan::RenderPlan()
+    : m_renderHints(QPainter::Antialiasing | QPainter::TextAntialiasing)
+    , m_staticItemCount(0)
+{
+}
+
+bool RenderPlan::isValid() const
+{
+    return !m_baseLayer.isNull();
+}
+
+QSize RenderPlan::imageSize() const
+{
+    return m_baseLayer.size();
+}
+
+int RenderPlan::staticItemCount() const
+{
+    return m_staticItemCount;
+}
+
+int RenderPlan::liveItemCount() const
+{
+    return m_liveItems.size();
+}
+
+QImage RenderPlan::render() const
+{
+    QImage image;
+    renderInto(&image);
+    return image;
+}
+
+void RenderPlan::renderInto(QImage *target) const
+{
+    if (!target || !isValid()) {
+        return;
+    }
+
+    // 复制静态底层：尺寸一致时直接覆盖已有缓冲区，避免每张标签重新分配
+    if (target->size() == m_baseLayer.size() && target->format() == m_baseLayer.format()) {
+        std::memcpy(target->bits(), m_baseLayer.constBits(), static_cast<size_t>(m_baseLayer.sizeInBytes()));
+    } else {
+        *target = m_baseLayer.copy();
+    }
+
+    if (m_liveItems.isEmpty() && m_overlayLayer.isNull()) {
+        return;
+    }
+
+    QPainter painter(target);
+    painter.setRenderHints(m_renderHints);
+
+    // 绘制动态元素
+    if (!m_liveItems.isEmpty()) {
+        painter.setTransform(m_transform);
+
+        QStyleOptionGraphicsItem option;
+        option.state = QStyle::State_None;
+
+        for (LabelItem *item : m_liveItems) {
+            painter.save();
+            item->paint(&painter, &option, nullptr);
+            painter.restore();
+        }
+
+        painter.resetTransform();
+    }
+
+    // 叠加顶层静态图层
+    if (!m_overlayLayer.isNull()) {
+        painter.drawImage(0, 0, m_overlayLayer);
+    }
+}
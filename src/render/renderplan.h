@@ -0,0 +1,82 @@
+#ifndef RENDERPLAN_H
+#define RENDERPLAN_H
+
+#include <QImage>
+#include <QList>
+#include <QPainter>
+#include <QTransform>
+
+class LabelItem;
+
+/**
+ * @brief 编译后的渲染计划
+ *
+ * 由LabelDocument::compileRenderPlan()生成。模板中不随记录变化的元素
+ * 预先按输出分辨率光栅化为静态图层，每次渲染只复制静态图层并在其上
+ * 绘制动态元素。
+ *
+ * 为保持元素的绘制顺序，位于第一个动态元素之下的静态元素进入底层，
+ * 位于最后一个动态元素之上的静态元素进入透明的顶层，
+ * 夹在动态元素之间的静态元素随动态元素一起实时绘制。
+ *
+ * 渲染计划引用文档中的元素，文档必须比渲染计划存活更久。
+ */
+class RenderPlan
+{
+public:
+    /**
+     * @brief 构造无效的渲染计划
+     */
+    RenderPlan();
+
+    /**
+     * @brief 判断渲染计划是否有效
+     * @return 是否有效
+     */
+    bool isValid() const;
+
+    /**
+     * @brief 获取输出图像大小
+     * @return 图像大小
+     */
+    QSize imageSize() const;
+
+    /**
+     * @brief 获取预先光栅化的元素数量
+     * @return 元素数量
+     */
+    int staticItemCount() const;
+
+    /**
+     * @brief 获取每次渲染需要实时绘制的元素数量
+     * @return 元素数量
+     */
+    int liveItemCount() const;
+
+    /**
+     * @brief 渲染一张标签
+     * @return 渲染结果
+     */
+    QImage render() const;
+
+    /**
+     * @brief 渲染到已有图像
+     *
+     * 图像大小和格式与计划一致时复用其缓冲区
+     *
+     * @param target 目标图像
+     */
+    void renderInto(QImage *target) const;
+
+private:
+    friend class LabelDocument;
+
+    QImage m_baseLayer;                 ///< 底层静态图层（含白色背景）
+    QImage m_overlayLayer;              ///< 顶层静态图层（透明背景，可能为空）
+    QList<LabelItem*> m_liveItems;      ///< 需要实时绘制的元素（按绘制顺序）
+    QTransform m_transform;             ///< 页面坐标到图像像素的变换
+    QPainter::RenderHints m_renderHints; ///< 绘制提示
+    int m_staticItemCount;              ///< 预先光栅化的元素数量
+};
+
+#endif // RENDERPLAN_H
@@ -0,0 +1,240 @@
+#include "items/barcodeitem.h"
+#include "items/barcodesymbol.h"
+#include "print/zplgraphicencoder.h"
+
+#include <QCoreApplication>
+#include <QList>
+#include <QTextStream>
+
+#include <random>
+
+// 失败的检查数
+static int failures = 0;
+
+/**
+ * @brief 检查条件，失败时输出用例名称和说明
+ * @param ok 条件
+ * @param name 用例名称
+ * @param detail 失败说明
+ */
+static void check(bool ok, const QString &name, const QString &detail = QString())
+{
+    if (ok) {
+        return;
+    }
+
+    ++failures;
+    QTextStream(stderr) << "FAIL " << name << (detail.isEmpty() ? QString() : ": " + detail) << "\n";
+}
+
+// 模块序列转为"1"（条）和"0"（空）组成的字符串，便于与固定结果比较
+static QString moduleString(const BarcodeModules &modules)
+{
+    QString text;
+    text.reserve(modules.size());
+    for (int i = 0; i < modules.size(); ++i) {
+        text += QLatin1Char(modules.at(i) ? '1' : '0');
+    }
+    return text;
+}
+
+/**
+ * @brief 比较编码结果与固定的模块序列
+ * @param name 用例名称
+ * @param modules 编码结果
+ * @param expected 期望的模块序列
+ */
+static void checkModules(const QString &name, const BarcodeModules &modules, const QString &expected)
+{
+    const QString actual = moduleString(modules);
+    check(actual == expected, name, QString("expected %1, got %2").arg(expected, actual));
+}
+
+// EAN-13：12位数据补全校验位1，左半部分按首位4的奇偶组合LGLLGG编码
+static void testEan13()
+{
+    const QString data = "400638133393";
+    const QString expected =
+        "101"
+        "0001101" "0100111" "0101111" "0111101" "0001001" "0110011"
+        "01010"
+        "1000010" "1000010" "1000010" "1110100" "1000010" "1100110"
+        "101";
+
+    checkModules("ean13/fallback", BarcodeItem::encodeFallback(data, BarcodeType::EAN13, false), expected);
+    checkModules("ean13/pattern", BarcodeItem::encodePattern(data, BarcodeType::EAN13, false), expected);
+
+    const BarcodeSymbol symbol = BarcodeSymbol::encode(data, BarcodeType::EAN13);
+    check(symbol.moduleCount() == 95, "ean13/modules", QString::number(symbol.moduleCount()));
+    check(symbol.text() == "4006381333931", "ean13/text", symbol.text());
+}
+
+// Code 128 B："Hello"，校验符 (104 + 40 + 69*2 + 76*3 + 76*4 + 79*5) % 103 = 76
+static void testCode128B()
+{
+    const QString data = "Hello";
+    const QString expected =
+        "11010010000"       // 开始符B
+        "11000101000"       // H
+        "10110010000"       // e
+        "11001010000"       // l
+        "11001010000"       // l
+        "10001111010"       // o
+        "11001010000"       // 校验符76
+        "1100011101011";    // 停止符
+
+    checkModules("code128b/fallback", BarcodeItem::encodeFallback(data, BarcodeType::Code128, false), expected);
+    checkModules("code128b/pattern", BarcodeItem::encodePattern(data, BarcodeType::Code128, false), expected);
+}
+
+/**
+ * @brief 解码ACS数据
+ *
+ * 按ZPL的定义独立实现，用于验证编码结果：G-Y、g-z为重复计数，
+ * ","将本行其余部分补0，"!"补1，":"重复上一行
+ *
+ * @param data ACS数据
+ * @param bytesPerRow 每行字节数
+ * @param rows 输出位行数据
+ * @return 数据格式是否正确
+ */
+static bool decodeAcs(const QByteArray &data, int bytesPerRow, QByteArray *rows)
+{
+    const int digits = bytesPerRow * 2;
+    QByteArray previous;
+    QByteArray line;
+    int count = 0;
+
+    rows->clear();
+    auto finishLine = [&]() {
+        previous = QByteArray::fromHex(line);
+        rows->append(previous);
+        line.clear();
+    };
+
+    for (char ch : data) {
+        if (ch >= 'G' && ch <= 'Y') {
+            count += ch - 'G' + 1;
+        } else if (ch >= 'g' && ch <= 'z') {
+            count += (ch - 'g' + 1) * 20;
+        } else if (ch == ',' || ch == '!') {
+            if (count != 0) {
+                return false;
+            }
+            line += QByteArray(digits - line.size(), ch == ',' ? '0' : 'F');
+            finishLine();
+        } else if (ch == ':') {
+            if (count != 0 || !line.isEmpty() || previous.isEmpty()) {
+                return false;
+            }
+            rows->append(previous);
+        } else if ((ch >= '0' && ch <= '9') || (ch >= 'A' && ch <= 'F')) {
+            line += QByteArray(qMax(1, count), ch);
+            count = 0;
+            if (line.size() > digits) {
+                return false;
+            }
+            if (line.size() == digits) {
+                finishLine();
+            }
+        } else {
+            return false;
+        }
+    }
+
+    return count == 0 && line.isEmpty();
+}
+
+// ACS：固定输入的编码结果，以及随机位行（含超过400次的重复）的往返
+static void testAcs()
+{
+    // FF000000、同上一行、0FFFFFFF、12345678、全0
+    const QByteArray rows = QByteArray::fromHex("FF000000" "FF000000" "0FFFFFFF" "12345678" "00000000");
+    const QByteArray expected = "HF,:0!12345678,";
+
+    const QByteArray acs = ZplGraphicEncoder::encodeAcs(rows, 4);
+    check(acs == expected, "acs/golden", QString("expected %1, got %2").arg(QString::fromLatin1(expected), QString::fromLatin1(acs)));
+    check(ZplGraphicEncoder::graphicField(rows, 4, ZplGraphicEncoder::Acs) == "^GFA,20,20,4," + expected,
+          "acs/graphic_field");
+
+    std::mt19937 random(20240601);
+    for (int bytesPerRow : {1, 3, 16, 250}) {
+        QByteArray source;
+        for (int y = 0; y < 40; ++y) {
+            QByteArray row(bytesPerRow, '\0');
+            switch (random() % 4) {
+                case 0: {
+                    // 长的空白和实心段，覆盖z计数和行尾补齐
+                    const int solid = static_cast<int>(random() % (bytesPerRow + 1));
+                    row.replace(0, solid, QByteArray(solid, '\xFF'));
+                    break;
+                }
+                case 1:
+                    if (!source.isEmpty()) {
+                        row = source.right(bytesPerRow);
+                    }
+                    break;
+                default:
+                    for (char &byte : row) {
+                        byte = static_cast<char>(random() % 3 == 0 ? random() : 0);
+                    }
+                    break;
+            }
+            source += row;
+        }
+
+        QByteArray decoded;
+        const QByteArray encoded = ZplGraphicEncoder::encodeAcs(source, bytesPerRow);
+        const bool ok = decodeAcs(encoded, bytesPerRow, &decoded);
+        check(ok && decoded == source, QString("acs/roundtrip/%1").arg(bytesPerRow));
+    }
+}
+
+// Z64：CRC-16/CCITT（XMODEM）的标准校验值，以及编码结果可以还原
+static void testZ64()
+{
+    check(ZplGraphicEncoder::crc16("123456789") == 0x31C3, "z64/crc_check_value",
+          QString::number(ZplGraphicEncoder::crc16("123456789"), 16));
+    check(ZplGraphicEncoder::crc16(QByteArray()) == 0, "z64/crc_empty");
+
+    const QByteArray rows = QByteArray::fromHex("FF000000" "FF000000" "0FFFFFFF" "12345678" "00000000").repeated(8);
+    const QByteArray z64 = ZplGraphicEncoder::encodeZ64(rows);
+
+    // :Z64:数据:CRC，CRC按数据部分计算，4位大写十六进制
+    const QList<QByteArray> parts = z64.split(':');
+    check(parts.size() == 4 && parts.at(0).isEmpty() && parts.at(1) == "Z64", "z64/format", QString::fromLatin1(z64));
+    if (parts.size() != 4) {
+        return;
+    }
+
+    const QByteArray crc = QByteArray::number(ZplGraphicEncoder::crc16(parts.at(2)), 16).toUpper().rightJustified(4, '0');
+    check(parts.at(3) == crc, "z64/crc", QString("expected %1, got %2").arg(QString::fromLatin1(crc), QString::fromLatin1(parts.at(3))));
+
+    // qUncompress需要4字节大端长度前缀
+    QByteArray compressed(4, '\0');
+    compressed[0] = static_cast<char>((rows.size() >> 24) & 0xFF);
+    compressed[1] = static_cast<char>((rows.size() >> 16) & 0xFF);
+    compressed[2] = static_cast<char>((rows.size() >> 8) & 0xFF);
+    compressed[3] = static_cast<char>(rows.size() & 0xFF);
+    compressed += QByteArray::fromBase64(parts.at(2));
+    check(qUncompress(compressed) == rows, "z64/roundtrip");
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("printer_golden_tests");
+
+    testEan13();
+    testCode128B();
+    testAcs();
+    testZ64();
+
+    if (failures > 0) {
+        QTextStream(stderr) << failures << " check(s) failed\n";
+        return 1;
+    }
+
+    QTextStream(stdout) << "all golden checks passed\n";
+    return 0;
+}
@@ -0,0 +1,289 @@
+#include "items/barcodeitem.h"
+#include "items/textitem.h"
+#include "models/datamerge.h"
+#include "models/labelmodels.h"
+#include "print/printsink.h"
+#include "print/printspooler.h"
+
+#include <QApplication>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QTextStream>
+#include <QThread>
+
+// 失败的检查数
+static int failures = 0;
+
+/**
+ * @brief 检查条件，失败时输出用例名称和说明
+ * @param ok 条件
+ * @param name 用例名称
+ * @param detail 失败说明
+ */
+static void check(bool ok, const QString &name, const QString &detail = QString())
+{
+    if (ok) {
+        return;
+    }
+
+    ++failures;
+    QTextStream(stderr) << "FAIL " << name << (detail.isEmpty() ? QString() : ": " + detail) << "\n";
+}
+
+// 等待任务完成的超时（毫秒）
+static const int WAIT_TIMEOUT = 30000;
+
+/**
+ * @brief 记录打开次数的模拟输出端
+ *
+ * 用于确认没有标签的任务不会打开输出端（不向打印机提交空任务）
+ */
+class CountingPrintSink : public SimulatedPrintSink
+{
+public:
+    using SimulatedPrintSink::SimulatedPrintSink;
+
+    bool open() override
+    {
+        m_opens.ref();
+        return SimulatedPrintSink::open();
+    }
+
+    int opens() const
+    {
+        return m_opens.loadAcquire();
+    }
+
+private:
+    QAtomicInt m_opens;     ///< 打开次数
+};
+
+/**
+ * @brief 记录任务结果
+ *
+ * 信号在发送线程中发出，直接连接并加锁
+ */
+struct JobResults
+{
+    mutable QMutex mutex;
+    QHash<int, bool> finished;      ///< 任务编号 -> 是否成功
+
+    void connect(PrintSpooler *spooler)
+    {
+        QObject::connect(spooler, &PrintSpooler::jobFinished, spooler,
+                         [this](int jobId, bool success, const QString &) {
+            QMutexLocker locker(&mutex);
+            finished.insert(jobId, success);
+        }, Qt::DirectConnection);
+    }
+
+    bool succeeded(int jobId) const
+    {
+        QMutexLocker locker(&mutex);
+        return finished.value(jobId, false);
+    }
+
+    bool failed(int jobId) const
+    {
+        QMutexLocker locker(&mutex);
+        return finished.contains(jobId) && !finished.value(jobId);
+    }
+};
+
+// 40 x 20 mm、203 dpi的标签，一个合并字段的文本
+static void setupDocument(LabelDocument *document)
+{
+    document->setPageSize(QPrinter::Custom);
+    document->setCustomSize(QSizeF(40, 20));
+    document->setDpi(203);
+
+    TextItem *text = new TextItem();
+    text->setText("{{name}}");
+    text->setPosition(QPointF(2, 2));
+    text->setSize(QSizeF(36, 8));
+    document->addItem(text);
+}
+
+// 统计字节中出现的次数
+static int countOf(const QByteArray &data, const QByteArray &needle)
+{
+    int count = 0;
+    for (int from = data.indexOf(needle); from >= 0; from = data.indexOf(needle, from + needle.size())) {
+        ++count;
+    }
+    return count;
+}
+
+// 标签数与字节：每张标签一个完整的^XA...^XZ格式，图形字段与页面尺寸一致
+static void testCountAndBytes()
+{
+    LabelDocument document;
+    setupDocument(&document);
+
+    CountingPrintSink *sink = new CountingPrintSink();
+    PrintSpooler spooler(sink);
+    JobResults results;
+    results.connect(&spooler);
+
+    QAtomicInt printed;
+    QObject::connect(&spooler, &PrintSpooler::labelPrinted, &spooler,
+                     [&printed](int, int, int) { printed.ref(); }, Qt::DirectConnection);
+
+    const QList<QStringList> records = {{"A"}, {"B"}, {"C"}, {"D"}, {"E"}};
+    const int mergeJob = spooler.submit(&document, QStringList() << "name", records);
+    const int copiesJob = spooler.submit(&document, 3);
+    check(mergeJob > 0 && copiesJob > 0, "count/submit");
+    check(spooler.waitForDone(WAIT_TIMEOUT), "count/wait");
+
+    const QByteArray data = sink->receivedData();
+    check(results.succeeded(mergeJob), "count/merge_job");
+    check(results.succeeded(copiesJob), "count/copies_job");
+    check(sink->labelCount() == 8, "count/labels", QString::number(sink->labelCount()));
+    check(printed.loadAcquire() == 8, "count/label_printed", QString::number(printed.loadAcquire()));
+    check(countOf(data, "^XA") == 8 && countOf(data, "^XZ") == 8, "count/formats");
+
+    // 40 mm @ 203 dpi = 320点，每行40字节；20 mm = 160行
+    check(countOf(data, "^PW320\n") == 8, "count/print_width");
+    check(countOf(data, "^LL160\n") == 8, "count/label_length");
+    check(countOf(data, ",6400,6400,40,") == 8, "count/graphic_bytes");
+    check(sink->opens() == 2, "count/opens", QString::number(sink->opens()));
+}
+
+// 慢速打印机：渲染和编码与发送重叠，打印机不应空等
+static void testIdleUnderSlowSink()
+{
+    LabelDocument document;
+    setupDocument(&document);
+
+    const double labelsPerSecond = 10;
+    const int copies = 10;
+    SimulatedPrintSink *sink = new SimulatedPrintSink(labelsPerSecond);
+    PrintSpooler spooler(sink);
+
+    QElapsedTimer timer;
+    timer.start();
+    const int jobId = spooler.submit(&document, copies);
+    check(jobId > 0, "idle/submit");
+    check(spooler.waitForDone(WAIT_TIMEOUT), "idle/wait");
+
+    // 每张标签100毫秒，全部空等不超过一张标签的时间
+    const qint64 period = static_cast<qint64>(1000 / labelsPerSecond);
+    check(sink->labelCount() == copies, "idle/labels", QString::number(sink->labelCount()));
+    check(sink->idleTime() < period, "idle/idle_time", QString("%1 ms").arg(sink->idleTime()));
+    check(timer.elapsed() >= copies * period, "idle/throttled", QString("%1 ms").arg(timer.elapsed()));
+}
+
+// 取消：正在打印的任务提前结束并报告失败，之后提交的任务不受影响
+static void testCancel()
+{
+    LabelDocument document;
+    setupDocument(&document);
+
+    const int copies = 50;
+    CountingPrintSink *sink = new CountingPrintSink(20);
+    PrintSpooler spooler(sink);
+    JobResults results;
+    results.connect(&spooler);
+
+    const int cancelledJob = spooler.submit(&document, copies);
+    const int queuedJob = spooler.submit(&document, copies);
+
+    // 第一张标签开始打印后再取消
+    QElapsedTimer timer;
+    timer.start();
+    while (sink->labelCount() == 0 && timer.elapsed() < WAIT_TIMEOUT) {
+        QThread::msleep(5);
+    }
+    spooler.cancel();
+    check(spooler.waitForDone(WAIT_TIMEOUT), "cancel/wait");
+
+    check(results.failed(cancelledJob), "cancel/job_failed");
+    check(results.failed(queuedJob), "cancel/queued_job_failed");
+    check(sink->labelCount() > 0 && sink->labelCount() < copies, "cancel/labels",
+          QString::number(sink->labelCount()));
+
+    // 排队中的任务被取消时没有标签，不打开输出端
+    check(sink->opens() == 1, "cancel/opens", QString::number(sink->opens()));
+
+    sink->clear();
+    const int laterJob = spooler.submit(&document, 2);
+    check(spooler.waitForDone(WAIT_TIMEOUT), "cancel/later_wait");
+    check(results.succeeded(laterJob), "cancel/later_job");
+    check(sink->labelCount() == 2, "cancel/later_labels", QString::number(sink->labelCount()));
+}
+
+// 第一条记录无效：任务失败，不打开输出端
+static void testInvalidRecord()
+{
+    LabelDocument document;
+    setupDocument(&document);
+
+    BarcodeItem *barcode = new BarcodeItem();
+    barcode->setType(BarcodeType::EAN13);
+    barcode->setData("{{code}}");
+    barcode->setPosition(QPointF(2, 10));
+    barcode->setSize(QSizeF(36, 8));
+    document.addItem(barcode);
+
+    CountingPrintSink *sink = new CountingPrintSink();
+    PrintSpooler spooler(sink);
+    JobResults results;
+    results.connect(&spooler);
+
+    const int jobId = spooler.submit(&document, QStringList() << "name" << "code",
+                                     QList<QStringList>() << (QStringList() << "A" << "abc"));
+    check(spooler.waitForDone(WAIT_TIMEOUT), "invalid/wait");
+    check(results.failed(jobId), "invalid/job_failed");
+    check(sink->labelCount() == 0, "invalid/labels", QString::number(sink->labelCount()));
+    check(sink->opens() == 0, "invalid/opens", QString::number(sink->opens()));
+}
+
+// 缺少校验位的ITF-14记录按补全后的14位写入，不会回退成Code 128
+static void testChecksumCompleted()
+{
+    LabelDocument document;
+    setupDocument(&document);
+
+    BarcodeItem *barcode = new BarcodeItem();
+    barcode->setType(BarcodeType::ITF14);
+    barcode->setData("{{code}}");
+    barcode->setPosition(QPointF(2, 10));
+    barcode->setSize(QSizeF(36, 8));
+    document.addItem(barcode);
+
+    DataMergeEngine engine(&document);
+    engine.setColumns(QStringList() << "name" << "code");
+
+    QString error;
+    check(engine.apply(QStringList() << "A" << "1234567890123", &error), "checksum/apply", error);
+    check(barcode->data() == "12345678901231", "checksum/data", barcode->data());
+    check(!BarcodeSymbol::encode(barcode->data(), BarcodeType::ITF14).isFallback(), "checksum/itf14_encoded");
+    engine.restore();
+}
+
+int main(int argc, char *argv[])
+{
+    // 没有显示环境时使用offscreen平台插件
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QApplication app(argc, argv);
+    app.setApplicationName("printer_spooler_tests");
+
+    testCountAndBytes();
+    testIdleUnderSlowSink();
+    testCancel();
+    testInvalidRecord();
+    testChecksumCompleted();
+
+    if (failures > 0) {
+        QTextStream(stderr) << failures << " check(s) failed\n";
+        return 1;
+    }
+
+    QTextStream(stdout) << "all spooler checks passed\n";
+    return 0;
+}